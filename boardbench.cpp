@@ -0,0 +1,146 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QTextStream>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "chessboard.h"
+
+/*
+
+Offscreen paint benchmark for ChessBoard; no window, no engine, no user files.
+
+qmake boardbench.pro && make -f Makefile.boardbench
+QT_QPA_PLATFORM=offscreen ./boardbench                         // 2000 positions from random games
+QT_QPA_PLATFORM=offscreen ./boardbench positions.fen -r 5       // One FEN per line, every position painted 5 times
+
+Prints the latency percentiles of drawBoard, drawPieces and a whole paintEvent (render into a QImage) per frame.
+
+*/
+
+// Befriended by ChessBoard so the draw functions can be timed one at a time
+class BoardBenchmark {
+    public:
+        explicit BoardBenchmark(ChessBoard &board) : board(board) {}
+
+        void setPosition(const std::string &fen) {
+            board.game->loadPosition(fen);
+            board.syncGui();
+        }
+
+        void drawBoard(QPainter &painter, const QRegion &dirty) { board.drawBoard(painter, dirty); }
+        void drawPieces(QPainter &painter, const QRegion &dirty) { board.drawPieces(painter, dirty); }
+
+    private:
+        ChessBoard &board;
+};
+
+// Positions from random legal games, so the piece count covers openings down to endgames; fixed seed for repeatable runs
+static std::vector<std::string> randomPositions(int count) {
+    std::vector<std::string> fens;
+    std::mt19937 gen(20240601);
+
+    chess::Board board;
+    while (int(fens.size()) < count) {
+        chess::Movelist moves;
+        chess::movegen::legalmoves(moves, board);
+        if (moves.empty() || board.isHalfMoveDraw() || board.isInsufficientMaterial()) {
+            board = chess::Board();
+            continue;
+        }
+
+        board.makeMove(moves[std::uniform_int_distribution<int>(0, int(moves.size()) - 1)(gen)]);
+        fens.push_back(board.getFen());
+    }
+    return fens;
+}
+
+// Microseconds at the given percentile of sorted nanosecond samples
+static double percentile(const std::vector<qint64> &sorted, double p) {
+    if (sorted.empty()) { return 0; }
+    const size_t index = std::min(sorted.size() - 1, size_t(p / 100.0 * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+static void report(QTextStream &out, const char *name, std::vector<qint64> &samples) {
+    std::sort(samples.begin(), samples.end());
+    out << QString("%1  p50 %2 us  p90 %3 us  p99 %4 us  max %5 us\n")
+               .arg(QLatin1String(name), -12)
+               .arg(percentile(samples, 50), 8, 'f', 1)
+               .arg(percentile(samples, 90), 8, 'f', 1)
+               .arg(percentile(samples, 99), 8, 'f', 1)
+               .arg(samples.empty() ? 0.0 : samples.back() / 1000.0, 8, 'f', 1);
+}
+
+int main(int argc, char *argv[]) {
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("fens", "File with one FEN per line; random positions if left out.");
+    QCommandLineOption countOption("n", "Number of random positions.", "count", "2000");
+    QCommandLineOption repeatOption("r", "Paint every position this many times.", "times", "1");
+    parser.addOption(countOption);
+    parser.addOption(repeatOption);
+    parser.process(a);
+
+    std::vector<std::string> fens;
+    if (!parser.positionalArguments().isEmpty()) {
+        QFile file(parser.positionalArguments().first());
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qWarning("Failed to open the FEN file");
+            return 1;
+        }
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            if (!line.isEmpty()) { fens.push_back(line.toStdString()); }
+        }
+    }
+    else {
+        fens = randomPositions(parser.value(countOption).toInt());
+    }
+    const int repeats = qMax(1, parser.value(repeatOption).toInt());
+
+    ChessBoard board;  // No UserInformation: no labels, clocks or engine, just the board
+    board.resize(board.sizeHint());
+    BoardBenchmark bench(board);
+
+    QImage image(board.size(), QImage::Format_ARGB32_Premultiplied);
+    const QRegion all(0, 0, image.width(), image.height());
+
+    std::vector<qint64> boardSamples, pieceSamples, frameSamples;
+    QElapsedTimer timer;
+    for (const std::string &fen : fens) {
+        bench.setPosition(fen);
+
+        for (int r = 0; r < repeats; ++r) {
+            {
+                QPainter painter(&image);
+                timer.start();
+                bench.drawBoard(painter, all);
+                boardSamples.push_back(timer.nsecsElapsed());
+
+                timer.start();
+                bench.drawPieces(painter, all);
+                pieceSamples.push_back(timer.nsecsElapsed());
+            }
+
+            // The whole paintEvent, as Qt would run it
+            timer.start();
+            board.render(&image);
+            frameSamples.push_back(timer.nsecsElapsed());
+        }
+    }
+
+    QTextStream out(stdout);
+    out << fens.size() << " positions x " << repeats << ", " << image.width() << "x" << image.height() << " px\n";
+    report(out, "drawBoard", boardSamples);
+    report(out, "drawPieces", pieceSamples);
+    report(out, "paintEvent", frameSamples);
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = boardbench
+DESTDIR = $$PWD
+
+# Own Makefile and build directories, so it can sit next to chess.pro without clobbering the game's build
+MAKEFILE = Makefile.boardbench
+OBJECTS_DIR = boardbench_build
+MOC_DIR = boardbench_build
+RCC_DIR = boardbench_build
+
+include(chess.pri)
+
+SOURCES += boardbench.cpp
@@ -0,0 +1,22 @@
+#pragma once
+#include <QPoint>
+
+// Conversions between the Gui's QPoint(col, row) (row 0 = rank 8) and chess::Square indices (a1 = 0 .. h8 = 63).
+// Everything is constexpr arithmetic; nothing searches, branches on the square, or allocates. Square names come from chess::uci.
+namespace coords {
+    constexpr int indexOf(int col, int row) { return ((7 - row) << 3) | col; }
+    constexpr int colOf(int index) { return index & 7; }
+    constexpr int rowOf(int index) { return 7 - (index >> 3); }
+
+    // Turning the board around for black is a 180 degree rotation: index 63 - i, ie: QPoint(7 - col, 7 - row)
+    constexpr int flip(int index) { return 63 - index; }
+
+    constexpr bool onBoard(int col, int row) { return col >= 0 && col < 8 && row >= 0 && row < 8; }
+
+    inline int indexOf(QPoint q) { return indexOf(q.x(), q.y()); }
+    inline QPoint pointOf(int index) { return QPoint(colOf(index), rowOf(index)); }
+    inline QPoint flip(QPoint q) { return QPoint(7 - q.x(), 7 - q.y()); }
+
+    static_assert(indexOf(4, 6) == 12 && colOf(12) == 4 && rowOf(12) == 6, "e2 is square 12, QPoint(4, 6)");
+    static_assert(flip(indexOf(0, 7)) == 63, "a1 flips onto h8");
+}
@@ -0,0 +1,45 @@
+# Everything the game and the paint benchmark share; each .pro adds its own main()
+QT += widgets
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD/extern
+
+SOURCES += $$PWD/mainwindow.cpp \
+           $$PWD/chessboard.cpp \
+           $$PWD/gamecontroller.cpp \
+           $$PWD/userinformation.cpp \
+           $$PWD/promptdialog.cpp \
+           $$PWD/enginemetrics.cpp \
+           $$PWD/enginepool.cpp \
+           $$PWD/engineprofile.cpp \
+           $$PWD/enginecache.cpp \
+           $$PWD/openingbook.cpp \
+           $$PWD/movelistmodel.cpp \
+           $$PWD/gamewriter.cpp \
+           $$PWD/gameindex.cpp \
+           $$PWD/gamerecord.cpp \
+           $$PWD/gamepgn.cpp
+
+HEADERS += $$PWD/mainwindow.h \
+           $$PWD/chessboard.h \
+           $$PWD/gamecontroller.h \
+           $$PWD/userinformation.h \
+           $$PWD/promptdialog.h \
+           $$PWD/runstockfish.h \
+           $$PWD/ucireader.h \
+           $$PWD/enginemetrics.h \
+           $$PWD/enginepool.h \
+           $$PWD/engineprofile.h \
+           $$PWD/enginecache.h \
+           $$PWD/openingbook.h \
+           $$PWD/boardcoords.h \
+           $$PWD/movelistmodel.h \
+           $$PWD/gamewriter.h \
+           $$PWD/gameindex.h \
+           $$PWD/gamerecord.h \
+           $$PWD/gamepgn.h \
+           $$PWD/extern/chess.hpp
+
+RESOURCES += $$PWD/pieces.qrc
+
+LIBS += -lssl -lcrypto
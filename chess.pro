@@ -1,20 +1,3 @@
-QT += widgets
-CONFIG += c++17
-
-INCLUDEPATH += $$PWD/extern
-
-SOURCES += main.cpp \
-           mainwindow.cpp \
-           chessboard.cpp \
-           userinformation.cpp \
-           promptdialog.cpp \
-
-
-HEADERS += mainwindow.h \
-           chessboard.h \
-           userinformation.h \
-           promptdialog.h \
-           runstockfish.h \
-           extern/chess.hpp
-
-LIBS += -lssl -lcrypto
\ No newline at end of file
+include(chess.pri)
+
+SOURCES += main.cpp
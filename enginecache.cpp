@@ -0,0 +1,127 @@
+#include "enginecache.h"
+#include <cstring>
+
+static const char CACHE_MAGIC[8] = {'C', 'H', 'E', 'S', 'S', 'E', 'C', '1'};  // File header, followed by the slot count
+static const int HEADER_SIZE = 16;
+
+EngineCache::EngineCache(const QString &filePath, int memoryEntries, int diskSlots)
+    : memoryCapacity(qMax(1, memoryEntries)) {
+        if (filePath.isEmpty()) { return; }
+
+        // Round the slot count up to a power of two so the index is a mask, not a modulo
+        quint64 count = 1;
+        while (count < quint64(qMax(1, diskSlots))) { count <<= 1; }
+        const qint64 size = HEADER_SIZE + qint64(count * sizeof(Slot));
+
+        file.setFileName(filePath);
+        if (!file.open(QIODevice::ReadWrite)) {
+            qWarning("Failed to open engine cache file; caching in memory only");
+            return;
+        }
+
+        // A new file, or one written with another layout, starts over empty
+        QByteArray header = file.read(HEADER_SIZE);
+        quint64 storedCount = 0;
+        if (header.size() == HEADER_SIZE) { std::memcpy(&storedCount, header.constData() + 8, sizeof(storedCount)); }
+        if (header.size() != HEADER_SIZE || std::memcmp(header.constData(), CACHE_MAGIC, 8) != 0 || storedCount != count || file.size() != size) {
+            file.resize(0);
+            file.resize(size);  // Zero filled, ie: every slot empty
+
+            header = QByteArray(CACHE_MAGIC, 8);
+            header.append(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.seek(0);
+            file.write(header);
+            file.flush();
+        }
+
+        uchar *view = file.map(0, size);
+        if (!view) {
+            qWarning("Failed to map engine cache file; caching in memory only");
+            file.close();
+            return;
+        }
+
+        table = reinterpret_cast<Slot*>(view + HEADER_SIZE);
+        slotMask = count - 1;
+}
+
+EngineCache::~EngineCache() {
+    // Unmapping hands the dirty pages back to the OS, which writes them out
+    if (table) { file.unmap(reinterpret_cast<uchar*>(table) - HEADER_SIZE); }
+}
+
+bool EngineCache::probe(const Key &key, Entry &entry) {
+    auto it = memory.find(key);
+    if (it != memory.end()) {
+        lru.splice(lru.begin(), lru, it.value().second);  // Now the most recently used
+        entry = it.value().first;
+        return true;
+    }
+
+    const Slot *slot = slotFor(key);
+    if (!slot || slot->move == 0 || slot->hash != key.hash || slot->elo != key.elo || slot->budget != key.budget) { return false; }
+
+    entry.move = slot->move;
+    entry.whiteCp = slot->whiteCp;
+    entry.depth = slot->depth;
+    remember(key, entry);
+
+    return true;
+}
+
+void EngineCache::store(const Key &key, const Entry &entry) {
+    if (entry.move == 0) { return; }  // Nothing worth keeping (eg: "bestmove (none)")
+
+    remember(key, entry);
+
+    if (Slot *slot = slotFor(key)) {
+        slot->hash = key.hash;
+        slot->move = entry.move;
+        slot->whiteCp = entry.whiteCp;
+        slot->elo = key.elo;
+        slot->budget = key.budget;
+        slot->depth = entry.depth;
+    }
+}
+
+quint8 EngineCache::budgetBucket(const SearchLimits &limits, bool whiteToMove) {
+    qint64 ms = limits.movetimeMs;
+
+    // On the clock, estimate what stockfish will spend: a slice of the remaining time plus the increment
+    if (ms == 0) {
+        ms = (whiteToMove ? limits.wtimeMs : limits.btimeMs) / 40 + (whiteToMove ? limits.wincMs : limits.bincMs);
+    }
+
+    quint8 bucket = 0;
+    while (ms > 1) {
+        ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void EngineCache::remember(const Key &key, const Entry &entry) {
+    auto it = memory.find(key);
+    if (it != memory.end()) {
+        it.value().first = entry;
+        lru.splice(lru.begin(), lru, it.value().second);
+        return;
+    }
+
+    // Full: drop the least recently used entry (it is still on disk)
+    if (memory.size() >= memoryCapacity) {
+        memory.remove(lru.back());
+        lru.pop_back();
+    }
+
+    lru.push_front(key);
+    memory.insert(key, qMakePair(entry, lru.begin()));
+}
+
+EngineCache::Slot* EngineCache::slotFor(const Key &key) const {
+    if (!table) { return nullptr; }
+
+    // Mix the strength and budget in, so one position at several strengths does not fight over one slot
+    const quint64 index = (key.hash ^ (quint64(key.elo) * 0x9E3779B97F4A7C15ULL) ^ (quint64(key.budget) << 17)) & slotMask;
+    return table + index;
+}
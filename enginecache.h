@@ -0,0 +1,68 @@
+#ifndef ENGINECACHE_H
+#define ENGINECACHE_H
+
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <list>
+#include "runstockfish.h"
+
+// Remembers stockfish's answers so positions seen before (openings, repeated games) are answered without a search.
+// Two tiers: an LRU of recent entries in memory, backed by a memory mapped file of fixed slots that survives restarts.
+class EngineCache {
+    public:
+        // A cached answer is only reused for the same position, the same opponent strength and a similar thinking time
+        struct Key {
+            quint64 hash = 0;  // chess::Board::hash() (zobrist)
+            quint16 elo = 0;
+            quint8 budget = 0;  // See budgetBucket
+
+            bool operator==(const Key &other) const { return hash == other.hash && elo == other.elo && budget == other.budget; }
+        };
+
+        struct Entry {
+            quint16 move = 0;  // Raw chess::Move; 0 (NO_MOVE) marks an empty slot
+            qint16 whiteCp = 0;  // Evaluation from white's point of view when the search ended
+            quint8 depth = 0;
+        };
+
+        EngineCache(const QString &filePath, int memoryEntries = 4096, int diskSlots = 1 << 16);  // Empty path keeps the memory tier only
+        ~EngineCache();
+
+        bool probe(const Key &key, Entry &entry);  // Memory first, then disk (a disk hit is promoted into memory)
+        void store(const Key &key, const Entry &entry);  // Written to both tiers
+
+        // log2 of roughly how long the engine would think, so searches of about the same length share entries
+        static quint8 budgetBucket(const SearchLimits &limits, bool whiteToMove);
+
+    private:
+        // One disk slot, 16 bytes; the slot index comes from the key, a colliding store simply replaces it
+        struct Slot {
+            quint64 hash;
+            quint16 move;
+            qint16 whiteCp;
+            quint16 elo;
+            quint8 budget;
+            quint8 depth;
+        };
+        static_assert(sizeof(Slot) == 16, "cache file layout");
+
+        int memoryCapacity;
+        std::list<Key> lru;  // Most recently used at the front
+        QHash<Key, QPair<Entry, std::list<Key>::iterator>> memory;
+
+        QFile file;
+        Slot *table = nullptr;  // Mapped view of the file, nullptr if it could not be opened
+        quint64 slotMask = 0;
+
+        void remember(const Key &key, const Entry &entry);  // Insert or refresh in the memory tier, evicting the oldest entry when full
+        Slot* slotFor(const Key &key) const;
+};
+
+// Allows EngineCache::Key to be used in a QHash
+inline uint qHash(const EngineCache::Key &key, uint seed = 0) {
+    return qHash(key.hash ^ (quint64(key.elo) << 48) ^ (quint64(key.budget) << 40), seed);
+}
+
+#endif
@@ -0,0 +1,43 @@
+#include "enginemetrics.h"
+#include <QDateTime>
+
+EngineMetrics::EngineMetrics(const QString &csvPath, QObject *parent)
+    : QObject(parent) {
+        if (csvPath.isEmpty()) { return; }
+
+        // Append, so the log covers every session; write the header only for a new file
+        csv_.setFileName(csvPath);
+        const bool fresh = !csv_.exists();
+        if (!csv_.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            qWarning("Failed to open engine metrics file");
+            return;
+        }
+
+        out_.setDevice(&csv_);
+        if (fresh) { out_ << "timestamp_ms,depth,seldepth,score,mate,nodes,nps,time_ms,hashfull\n"; }
+}
+
+void EngineMetrics::record(const EngineInfo &info) {
+    last_ = info;
+    inSearch_ = true;
+
+    // QTextStream buffers; the file is only flushed once per search in endSearch
+    if (out_.device()) {
+        out_ << QDateTime::currentMSecsSinceEpoch() << ',' << info.depth << ',' << info.seldepth << ','
+             << info.score << ',' << (info.mate ? 1 : 0) << ',' << info.nodes << ',' << info.nps << ','
+             << info.timeMs << ',' << info.hashfull << '\n';
+    }
+}
+
+void EngineMetrics::endSearch() {
+    if (!inSearch_) { return; }  // The search printed no scored info (eg: a forced move)
+    inSearch_ = false;
+
+    // The last reading of a search covers the whole search, so its nps is the one worth keeping
+    searches_++;
+    npsSum_ += last_.nps;
+    if (last_.nps > peakNps_) { peakNps_ = last_.nps; }
+
+    if (out_.device()) { out_.flush(); }
+    emit totalsChanged();
+}
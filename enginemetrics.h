@@ -0,0 +1,39 @@
+#ifndef ENGINEMETRICS_H
+#define ENGINEMETRICS_H
+
+#include <QObject>
+#include <QFile>
+#include <QTextStream>
+#include "ucireader.h"
+
+// Metrics sink for the engine's info stream; keeps throughput totals and optionally logs every line to a CSV file
+class EngineMetrics : public QObject {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
+
+    public:
+        EngineMetrics(const QString &csvPath = QString(), QObject *parent = nullptr);  // Empty path keeps the totals in memory only
+
+        qint64 peakNps() const { return peakNps_; }  // Best final nps of any search
+        qint64 averageNps() const { return searches_ ? npsSum_ / searches_ : 0; }  // Mean final nps over all searches
+        int searches() const { return searches_; }
+
+    signals:
+        void totalsChanged();  // A search was folded into the totals; main shows them in the status bar
+
+    // Signals connect to slot actions; the signal is triggered, and the slot acts
+    public slots:
+        void record(const EngineInfo &info);  // Connected to StockfishEngine::infoReady
+        void endSearch();  // Connected to StockfishEngine::bestMoveReady; folds the search's last reading into the totals
+
+    private:
+        QFile csv_;
+        QTextStream out_;
+
+        EngineInfo last_;
+        bool inSearch_ = false;
+        qint64 peakNps_ = 0;
+        qint64 npsSum_ = 0;
+        int searches_ = 0;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "enginepool.h"
+#include <QTimer>
+
+EnginePool::EnginePool(const QString &enginePath, int size, const EngineProfile &idleProfile, QObject *parent)
+    : QObject(parent), enginePath(enginePath), idleProfile(idleProfile) {
+        // Engines are children of the pool, so they shut down with it
+        for (int i = 0; i < qMax(1, size); ++i) {
+            StockfishEngine *engine = new StockfishEngine(this);
+            connectCrashed(engine);
+
+            engines.append(engine);
+            idle.append(engine);
+        }
+}
+
+int EnginePool::start() {
+    int started = 0;
+    for (StockfishEngine *engine : engines) {
+        if (engine->start(enginePath, idleProfile)) { started++; }
+        else { qWarning("Failed to start a pooled Stockfish"); }
+    }
+    return started;
+}
+
+StockfishEngine* EnginePool::acquire(const EngineProfile &profile) {
+    // An engine already running this profile skips the resize (and its isready wait): play and review each keep their own.
+    // Engines with a crash restart on its way are left to it.
+    QList<StockfishEngine*> candidates;
+    for (StockfishEngine *engine : idle) {
+        if (restarts.value(engine).pending) { continue; }
+
+        if (engine->profile() == profile) { candidates.prepend(engine); }
+        else { candidates.append(engine); }
+    }
+
+    for (StockfishEngine *engine : candidates) {
+        idle.removeOne(engine);
+
+        // Failed at startup or died while idle: try once more, and never lend out an engine that is not answering
+        if ((engine->isRunning() || engine->restart()) && engine->applyProfile(profile)) { return engine; }
+
+        qWarning("A pooled Stockfish did not come up; taking it out of the pool");
+        failed.append(engine);
+        emit engineFailed(engine);
+    }
+    return nullptr;
+}
+
+void EnginePool::release(StockfishEngine *engine) {
+    if (!engine || !engines.contains(engine) || idle.contains(engine)) { return; }
+
+    // Clear whatever the last job left behind: running search, strength limit, hash. The profile stays for the next lease of its kind.
+    engine->stopSearch();
+    engine->clearElo();
+    engine->markNewGame();
+
+    // Leases connect their own slots to the engine; cut them so the next job starts clean
+    disconnect(engine, nullptr, nullptr, nullptr);
+    connectCrashed(engine);
+
+    if (!failed.contains(engine)) { idle.append(engine); }
+}
+
+// Queued, so a process that dies inside a blocking wait (eg: the uci handshake of a restart) is not restarted from within that wait
+void EnginePool::connectCrashed(StockfishEngine *engine) {
+    connect(engine, &StockfishEngine::crashed, this, [this, engine]() { restartCrashed(engine); }, Qt::QueuedConnection);
+}
+
+void EnginePool::restartCrashed(StockfishEngine *engine) {
+    Restarts &state = restarts[engine];
+    if (state.pending || failed.contains(engine)) { return; }  // A failed restart also reports a crash; one retry is already on its way
+    if (state.since.isValid() && state.since.elapsed() > stableMs) { state.attempts = 0; }  // It ran fine for a while; this is a new problem
+
+    if (state.attempts >= maxRestarts) {
+        qWarning("Stockfish exited %d times in a row; giving up on it", maxRestarts);
+        failed.append(engine);
+        idle.removeAll(engine);
+        emit engineFailed(engine);
+        return;
+    }
+
+    const int delayMs = restartDelayMs << state.attempts;  // 250 ms, 500 ms, 1 s, ...
+    state.attempts++;
+    state.pending = true;
+    qWarning("Stockfish exited unexpectedly; restarting in %d ms", delayMs);
+
+    QTimer::singleShot(delayMs, this, [this, engine]() {
+        // restart() keeps the Elo the lease had set, so a game in progress carries on at the same strength
+        const bool ok = engine->restart();
+        restarts[engine].pending = false;
+
+        if (ok) {
+            restarts[engine].since.start();
+            emit restarted(engine);
+        }
+        else {
+            qWarning("Failed to restart Stockfish");
+            restartCrashed(engine);  // Next attempt (or give up); a crash reported by the failed start is dropped as already pending
+        }
+    });
+}
@@ -0,0 +1,53 @@
+#ifndef ENGINEPOOL_H
+#define ENGINEPOOL_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QElapsedTimer>
+#include "runstockfish.h"
+
+// Owns a fixed set of Stockfish processes so games and analysis jobs can each hold their own engine at the same time.
+// Engines are leased with acquire() and handed back with release(), which resets them for the next job.
+class EnginePool : public QObject {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
+
+    public:
+        EnginePool(const QString &enginePath, int size, const EngineProfile &idleProfile = EngineProfile::play(), QObject *parent = nullptr);
+
+        int start();  // Spawn every engine up front with the idle profile; returns how many came up
+        StockfishEngine* acquire(const EngineProfile &profile);  // Lease an idle engine set up for the job; nullptr if every engine is leased or down
+        void release(StockfishEngine *engine);  // Return a lease; the engine is stopped and sent ucinewgame, and keeps its profile
+
+        int size() const { return engines.size(); }
+        int idleCount() const { return idle.size(); }
+
+    signals:
+        void engineFailed(StockfishEngine *engine);  // Crashed maxRestarts times in a row (or would not come up for a lease); it is not lent out again
+        void restarted(StockfishEngine *engine);  // A crashed engine is back; the search it was running is gone, so its lease has to ask again
+
+    private:
+        QString enginePath;
+        EngineProfile idleProfile;  // What every engine starts with; after that each keeps the profile of its last lease
+        QList<StockfishEngine*> engines;  // Every engine, leased or not
+        QList<StockfishEngine*> idle;  // Engines free to lease
+
+        // Crash recovery: restarts run from the event loop, each one waits twice as long as the last, and a run of maxRestarts
+        // crashes (none of them stableMs after the previous restart) takes the engine out of the pool for good
+        static constexpr int maxRestarts = 5;
+        static constexpr int restartDelayMs = 250;
+        static constexpr int stableMs = 60 * 1000;
+        struct Restarts {
+            int attempts = 0;
+            bool pending = false;  // A restart is scheduled or running
+            QElapsedTimer since;  // Time since the last successful restart
+        };
+        QHash<StockfishEngine*, Restarts> restarts;
+        QList<StockfishEngine*> failed;
+
+        void connectCrashed(StockfishEngine *engine);
+        void restartCrashed(StockfishEngine *engine);  // Queued from each engine's crashed signal
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "engineprofile.h"
+#include <QSettings>
+#include <QThread>
+
+#ifdef Q_OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+EngineProfile EngineProfile::play() {
+    EngineProfile p;
+    p.threads = 1;
+    p.hashMb = 64;
+    p.ponder = true;  // Keep thinking while the user does, so predicted replies come back at once
+    return p;
+}
+
+EngineProfile EngineProfile::analysis() {
+    EngineProfile p;
+    p.threads = autoThreads();
+    p.hashMb = autoHashMb();
+    return p;
+}
+
+EngineProfile EngineProfile::load(const QString &iniPath, const QString &group, const EngineProfile &defaults) {
+    EngineProfile p = defaults;
+    if (iniPath.isEmpty()) { return p; }
+
+    QSettings settings(iniPath, QSettings::IniFormat);
+    settings.beginGroup(group);
+    for (const QString &key : settings.childKeys()) {
+        p.set(key, settings.value(key).toString());
+    }
+    settings.endGroup();
+
+    return p;
+}
+
+void EngineProfile::set(const QString &key, const QString &value) {
+    const QString k = key.toLower();
+    const bool isAuto = (value.trimmed().toLower() == "auto");
+
+    // A value that fails to parse leaves the current setting alone
+    bool ok = false;
+    const int n = value.toInt(&ok);
+
+    if (k == "threads")           { threads = isAuto ? autoThreads() : (ok && n > 0 ? n : threads); }
+    else if (k == "hash")         { hashMb = isAuto ? autoHashMb() : (ok && n > 0 ? n : hashMb); }
+    else if (k == "multipv")      { multiPv = (ok && n > 0) ? n : multiPv; }
+    else if (k == "moveoverhead") { moveOverheadMs = (ok && n >= 0) ? n : moveOverheadMs; }
+    else if (k == "skill")        { skillLevel = (ok && n >= 0 && n <= 20) ? n : skillLevel; }
+    else if (k == "ponder")       { ponder = (value.trimmed().toLower() == "true" || value.trimmed() == "1"); }
+    else if (k == "numa")         { numaPolicy = value.trimmed(); }
+    else                          { extraOptions[key] = value; }  // Passed through to the engine untouched
+}
+
+QStringList EngineProfile::setoptionCommands() const {
+    QStringList cmds;
+    cmds << QString("setoption name Threads value %1").arg(threads)
+         << QString("setoption name Hash value %1").arg(hashMb)
+         << QString("setoption name Ponder value %1").arg(ponder ? "true" : "false")
+         << QString("setoption name MultiPV value %1").arg(multiPv)
+         << QString("setoption name Move Overhead value %1").arg(moveOverheadMs)
+         << QString("setoption name Skill Level value %1").arg(skillLevel);
+
+    if (!numaPolicy.isEmpty()) { cmds << QString("setoption name NumaPolicy value %1").arg(numaPolicy); }
+
+    for (auto it = extraOptions.constBegin(); it != extraOptions.constEnd(); ++it) {
+        cmds << QString("setoption name %1 value %2").arg(it.key(), it.value());
+    }
+    return cmds;
+}
+
+int EngineProfile::autoThreads() {
+    const int cores = QThread::idealThreadCount();
+    if (cores <= 2) { return 1; }
+    return cores - 1;  // Keep one core free so the board stays responsive while the engine searches
+}
+
+int EngineProfile::autoHashMb() {
+    qint64 freeMb = 0;
+
+#ifdef Q_OS_WIN
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) { freeMb = qint64(status.ullAvailPhys / (1024 * 1024)); }
+#else
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && pageSize > 0) { freeMb = qint64(pages) * pageSize / (1024 * 1024); }
+#endif
+
+    // Largest power of two that fits in a quarter of what is free
+    qint64 hash = 16;
+    while (hash * 2 <= freeMb / 4 && hash * 2 <= 32768) { hash *= 2; }
+    return int(hash);
+}
+
+bool EngineProfile::operator==(const EngineProfile &other) const {
+    return threads == other.threads && hashMb == other.hashMb && multiPv == other.multiPv &&
+           moveOverheadMs == other.moveOverheadMs && skillLevel == other.skillLevel && ponder == other.ponder &&
+           numaPolicy == other.numaPolicy && extraOptions == other.extraOptions;
+}
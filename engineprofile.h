@@ -0,0 +1,39 @@
+#ifndef ENGINEPROFILE_H
+#define ENGINEPROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+
+// The resources and options a Stockfish process is started with, per use case.
+// play() is sized for a single game against the user, analysis() for deep searches that may use the whole machine.
+struct EngineProfile {
+    int threads = 1;
+    int hashMb = 64;
+    int multiPv = 1;
+    int moveOverheadMs = 0;
+    int skillLevel = 20;
+    bool ponder = false;
+    QString numaPolicy;  // Stockfish 17+ "NumaPolicy" (auto, system, none, hardware); empty keeps the engine default
+    QMap<QString, QString> extraOptions;  // Any other uci option, sent as "setoption name <key> value <value>"
+
+    static EngineProfile play();  // One thread, a small hash (a limited strength opponent gains nothing from more), pondering on
+    static EngineProfile analysis();  // Every core and a share of the free memory
+
+    // Read a profile from an ini file group (eg: [analysis]); keys that are missing keep the values in defaults
+    static EngineProfile load(const QString &iniPath, const QString &group, const EngineProfile &defaults);
+
+    // Set one value by name: threads, hash, multipv, moveoverhead, skill, ponder, numa, or any uci option name.
+    // "auto" for threads or hash sizes them from the hardware.
+    void set(const QString &key, const QString &value);
+
+    QStringList setoptionCommands() const;  // The uci commands that apply this profile
+
+    static int autoThreads();  // QThread::idealThreadCount(), leaving one core for the Gui on bigger machines
+    static int autoHashMb();  // A quarter of the free physical memory, as a power of two between 16 MB and 32 GB
+
+    bool operator==(const EngineProfile &other) const;
+    bool operator!=(const EngineProfile &other) const { return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,430 @@
+#include "gamecontroller.h"
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+
+GameController::GameController(QObject *parent)
+    : QObject(parent) {
+        // FEN: Lists ranks (separated by '/', numbers represent empty), color to move, castling abilities (capitol is white, lowercase is black),
+        // En passant square (- if not possible, something like e6 if it is), halfmove counter, fullmove counter
+        board_ = chess::Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+        resetThreefold();
+        resetClocks();
+
+        flagTimer.setSingleShot(true);
+        connect(&flagTimer, &QTimer::timeout, this, &GameController::checkFlag);
+}
+
+// Pass a copy of UserInformation to the class so we can access its public members
+void GameController::setInfo(UserInformation* i) {
+    info = i;
+    resetClocks();  // The time control comes from UserInformation
+}
+
+// Bucket the moves by from square once per position, so selecting, highlighting and validating a click are single bit tests
+void GameController::generateLegalMoves() {
+    if (movesValid && movesHash == board_.hash()) { return; }  // Clicks that only select pieces keep the position
+    movesHash = board_.hash();
+    movesValid = true;
+
+    legalMoves.clear();
+    chess::movegen::legalmoves(legalMoves, board_);
+
+    movesFrom.fill(0);
+    for (const chess::Move &move : legalMoves) {
+        movesFrom[move.from().index()] |= 1ULL << move.to().index();
+    }
+}
+
+quint64 GameController::targetsFrom(chess::Square square) {
+    generateLegalMoves();  // Once per position
+    return movesFrom[square.index()];  // None for an empty or enemy square
+}
+
+void GameController::loadPosition(const std::string& fen) {
+    board_.setFen(fen);
+}
+
+// List holds positions; when we get three consecutive with the same position and castle rights, its a threefold repitition)
+void GameController::resetThreefold() {
+    threeMoveStale.clear();
+    threeMoveCastle.clear();
+    threeBool = false;
+
+    QStringList threeMoves = QString::fromStdString(board_.getFen()).split(' ');
+    threeMoveStale.push_back(threeMoves[0].toStdString());
+    threeMoveCastle.push_back(threeMoves[2].toStdString());
+}
+
+// Game flow: every move goes through advance(), which decides whose turn it is (or that the game is over) from board_
+void GameController::startGame() {
+    if (info->gameMode == 1) {
+        // Review replays the recorded moves on board_
+        board_ = info->reviewStart;
+        reviewPly = 0;
+        state_ = State::Reviewing;
+        emit movesCleared(board_.sideToMove() == chess::Color::BLACK, int(board_.fullMoveNumber()));  // Imported games may start mid-game
+
+        leaseEngine(info->analysisProfile);
+        if (info->engine) { info->engine->markNewGame(QString::fromStdString(board_.getFen())); }
+        emit positionChanged();
+        analysePosition();
+    }
+    else {
+        if (info->elo != 1) {
+            leaseEngine(info->playProfile);
+            if (info->engine) {
+                connect(info->engine, &StockfishEngine::bestMoveReady, this, &GameController::onEngineMove);  // Computer moves arrive asynchronously
+                info->engine->markNewGame();
+                info->engine->setElo(info->elo);
+            }
+        }
+        advance();  // The computer may have white
+    }
+}
+
+bool GameController::readyForUser() const {
+    return !info || state_ == State::AwaitingUser;  // No game yet (or boardbench) takes every click; otherwise not while stockfish is thinking or the game is over
+}
+
+void GameController::retryComputerMove() {
+    if (info && state_ == State::AwaitingEngine && !(info->engine && info->engine->isSearching())) { requestComputerMove(); }
+}
+
+bool GameController::userMove(chess::Square from, chess::Square to) {
+    if (!info || state_ != State::AwaitingUser || !playMove(from, to)) { return false; }
+
+    advance();
+    return true;
+}
+
+void GameController::reviewStep(bool forward) {
+    if (state_ != State::Reviewing) { return; }
+
+    // Previous move
+    if (!forward && reviewPly > 0) {
+        board_.unmakeMove(info->reviewMoves[--reviewPly]);  // Captures, castles, en passant and promotions all undo on board_
+        if (info->engine) { info->engine->popMove(); }
+        emit moveTakenBack();
+        emit positionChanged();
+        analysePosition();
+    }
+    // Out of forward moves: end a game
+    else if (reviewPly == info->reviewMoves.size()) { endReview(); }
+    // Next move
+    else if (forward) {
+        const chess::Move move = info->reviewMoves[reviewPly++];  // Stored as played, so it is legal here
+        emit movePlayed(QString::fromStdString(chess::uci::moveToSan(board_, move)));
+        board_.makeMove(move);
+        if (info->engine) {
+            info->engine->stopSearch();  // Before the position changes under it
+            info->engine->pushMove(QString::fromStdString(chess::uci::moveToUci(move)));
+        }
+        emit positionChanged();
+        analysePosition();
+    }
+}
+
+void GameController::analysePosition() {
+    if (!info->engine) { return; }
+
+    info->engine->stopSearch();
+    info->engine->searchBestMove(SearchLimits::movetime(analysisMs));  // Only infoReady is connected; the bestmove is dropped
+}
+
+void GameController::endReview() {
+    const QString& result = info->sReviewInfo;
+    const bool whiteWon = (result.contains("Win") && info->isWhite) || (result.contains("Loss") && !(info->isWhite));
+    const bool blackWon = (result.contains("Loss") && info->isWhite) || (result.contains("Win") && !(info->isWhite));
+    const QString winner = whiteWon ? "White wins!" : blackWon ? "Black wins!" : "It's a Draw!";
+
+    if (result.contains("Quit") || result.contains("Undetermined")) { gameOver("Game Over", "Erroneous Finish."); }
+    else if (result.contains("Stalemate"))                          { gameOver("Stalemate", "It's a Draw!"); }
+    else if (result.contains("Insufficient Material"))              { gameOver("Insufficient Material", "It's a Draw!"); }
+    else if (result.contains("Threefold Repetition"))               { gameOver("Threefold Repitition", "It's a Draw!"); }
+    else if (result.contains("Fifty Move Rule"))                    { gameOver("Fifty Move Rule", "It's a Draw!"); }
+    else if (result.contains("Adjudicated"))                        { gameOver("Game Over", winner); }  // Imported games decided off the board
+    else if (result.contains("Time Forfeit"))                       { gameOver("Time", winner); }
+    else if (whiteWon || blackWon)                                  { gameOver("Checkmate", winner); }
+}
+
+// Make the move from -> to (castles land on the rook, chess.hpp style) on board_ and write it to the user file; false if it is not legal
+bool GameController::playMove(chess::Square from, chess::Square to) {
+    generateLegalMoves();
+
+    for (const chess::Move& move : legalMoves) {
+        if (move.from() == from && move.to() == to) {
+            // Charge the mover before the side to move flips; a move that arrives after the flag fell (before flagTimer fired) loses
+            if (!punchClock()) {
+                loseOnTime();
+                return false;
+            }
+
+            // Write our move to the user record
+            if (!info->username.empty())
+                info->writeMove(info->username, move);
+
+            const QString san = QString::fromStdString(chess::uci::moveToSan(board_, move));  // Needs the position before the move
+
+            board_.makeMove(move);  // Update board_ with the new move
+            emit movePlayed(san);
+            if (info->engine) { info->engine->pushMove(QString::fromStdString(chess::uci::moveToUci(move))); }  // Keep the engine's move list in step
+            emit positionChanged();  // Captures, castling, en passant and promotion all come from board_
+
+            // Check for threefold repitition
+            QStringList threeMoves = QString::fromStdString(board_.getFen()).split(' ');
+            if (threeMoves[3] == "-") {  // If the move has en passant rights, it cannot be a repeat
+                threeMoveStale.push_back(threeMoves[0].toStdString());  // Add on the relevant part of the FEN
+                threeMoveCastle.push_back(threeMoves[2].toStdString());  // Check for changes in castling rights
+                if (threeMoveStale.size() == 10) {
+                    // If we have three repeated positions including unchanged castling rights
+                    if (threeMoveStale[0] == threeMoveStale[4] && threeMoveStale[0] == threeMoveStale[8] &&
+                        threeMoveStale[1] == threeMoveStale[5] && threeMoveStale[1] == threeMoveStale[9] &&
+                        threeMoveCastle[0] == threeMoveCastle[8] && threeMoveCastle[1] == threeMoveCastle[9]) {
+                            threeBool = true;  // Ends the game in advance()
+                    }
+                    // Shift down our vectors and resize them to 9 so we can push the next move
+                    for (int i = 0; i <= 8; i++) {
+                        threeMoveStale[i] = threeMoveStale[i + 1];
+                        threeMoveCastle[i] = threeMoveCastle[i + 1];
+                    }
+                    threeMoveStale.erase(threeMoveStale.begin() + 9);
+                    threeMoveCastle.erase(threeMoveCastle.begin() + 9);
+                }
+            }
+
+            if (info->elo != 1) { info->computerTurn = !info->computerTurn; }  // The other side moves next
+            return true;
+        }
+    }
+    return false;
+}
+
+void GameController::advance() {
+    generateLegalMoves();
+    if (checkGameOver()) { return; }
+
+    if (info->elo != 1 && info->computerTurn) { requestComputerMove(); }
+    else {
+        info->computerTurn = false;  // Friend games never hand the move to the computer
+        state_ = State::AwaitingUser;
+    }
+}
+
+// Record the result and end the game if board_ is finished
+bool GameController::checkGameOver() {
+    QStringList fenParts = QString::fromStdString(board_.getFen()).split(' ');
+
+    if (legalMoves.empty() && board_.inCheck()) {
+        info->writeCM(info->username, fenParts[1].toStdString());
+        gameOver("Checkmate", fenParts[1] == "b" ? "White wins!" : "Black wins!");  // The side to move is mated
+    }
+    else if (legalMoves.empty()) {
+        info->writeStale(info->username);
+        gameOver("Stalemate", "It's a Draw!");
+    }
+    else if (board_.isInsufficientMaterial()) {
+        info->writeIN(info->username);
+        gameOver("Insufficient Material", "It's a Draw!");
+    }
+    else if (threeBool) {
+        info->writeThree(info->username);
+        gameOver("Threefold Repitition", "It's a Draw!");
+    }
+    // Check if fifty-move draw condition triggered
+    else if (fenParts[4] == "100") {
+        info->writeFifty(info->username);
+        gameOver("Fifty Move Rule", "It's a Draw!");
+    }
+    else { return false; }
+
+    return true;
+}
+
+void GameController::requestComputerMove() {
+    state_ = State::AwaitingEngine;
+
+    // Book openings are played instantly, with some variety at low Elo
+    const chess::Move bookMove = info->openingBook ? info->openingBook->probe(board_, legalMoves, info->elo) : chess::Move(chess::Move::NO_MOVE);
+    if (bookMove != chess::Move::NO_MOVE) {
+        if (info->engine) { info->engine->stopSearch(); }  // Same as a cache hit: no ponder may outlive the engine's turn
+        playComputerMove(QString::fromStdString(chess::uci::moveToUci(bookMove)));
+        return;
+    }
+
+    // Positions stockfish has answered before (repeated games) come straight from the cache
+    const EngineCache::Key key = cacheKey();
+    EngineCache::Entry hit;
+    if (info->engineCache && info->engineCache->probe(key, hit) &&
+        std::find(legalMoves.begin(), legalMoves.end(), chess::Move(hit.move)) != legalMoves.end())  // Guard against hash collisions
+    {
+        if (info->engine) { info->engine->stopSearch(); }  // End the ponder from the last engine move; it would search (and report info) all through the user's turn
+        playComputerMove(QString::fromStdString(chess::uci::moveToUci(chess::Move(hit.move))));
+        return;
+    }
+
+    // Otherwise ask stockfish without blocking the Gui; onEngineMove plays the answer
+    if (info->engine && !info->engine->isSearching()) {
+        searchKey = key;
+        info->engine->searchBestMove(searchLimits());
+    }
+}
+
+// The move is a four or five char uci string (eg: "e2e4")
+void GameController::playComputerMove(const QString& move) {
+    const chess::Move mv = chess::uci::uciToMove(board_, move.toStdString());  // Castles come back on the rook square, as playMove expects
+
+    if (!playMove(mv.from(), mv.to())) { return; }  // Not legal here; stay on the computer's turn so the next click asks again
+    emit computerMoved(mv.to());
+    advance();
+
+    // Let stockfish think on the reply it expects while the user decides; a move that ended the game leaves nothing to ponder
+    if (state_ == State::AwaitingUser && info->engine) { info->engine->ponder(searchLimits()); }
+}
+
+// Connected to StockfishEngine::bestMoveReady in startGame
+void GameController::onEngineMove(const QString& move) {
+    if (!info || state_ != State::AwaitingEngine || move.isEmpty()) { return; }  // Stale or failed search; the next click asks again
+
+    // Keep the answer for the next time this position comes up (board_ is still the searched position)
+    if (info->engineCache) {
+        EngineCache::Entry entry;
+        entry.move = chess::uci::uciToMove(board_, move.toStdString()).move();
+        entry.whiteCp = qint16(engineInfo_.whiteCp());
+        entry.depth = quint8(qMin(engineInfo_.depth, 255));
+        info->engineCache->store(searchKey, entry);
+    }
+
+    playComputerMove(move);  // Played as soon as it arrives
+}
+
+// Connected to StockfishEngine::infoReady in leaseEngine
+void GameController::onEngineInfo(const EngineInfo& info) {
+    engineInfo_ = info;
+    emit evaluationChanged();
+}
+
+// Connected to EnginePool::restarted in main; the crash ended the search with an empty bestmove, which onEngineMove dropped
+void GameController::onEngineRestarted(StockfishEngine* engine) {
+    if (!info || engine != info->engine) { return; }  // Another lease, or an idle engine
+
+    if (state_ == State::AwaitingEngine) { requestComputerMove(); }
+    else if (state_ == State::Reviewing) { analysePosition(); }
+}
+
+void GameController::leaseEngine(const EngineProfile& profile) {
+    if (info->engine || !info->enginePool) { return; }
+
+    info->engine = info->enginePool->acquire(profile);
+    if (!info->engine) {
+        qWarning("No engine free for the game");
+        return;
+    }
+
+    connect(info->engine, &StockfishEngine::infoReady, this, &GameController::onEngineInfo);  // The evaluation bar, in play and review
+    emit engineLeased(info->engine);
+}
+
+void GameController::releaseEngine() {
+    if (!info || !info->engine) { return; }
+
+    info->enginePool->release(info->engine);  // Stops it, resets strength and hash, and cuts every connection made for the game
+    info->engine = nullptr;
+}
+
+void GameController::resetClocks() {
+    whiteClockMs = info ? info->clockStartMs : UserInformation::defaultClockStartMs;
+    blackClockMs = whiteClockMs;
+    turnTimer.invalidate();  // Not running until white's first move
+    flagTimer.stop();
+}
+
+void GameController::stopClocks() {
+    qint64 &clock = (board_.sideToMove() == chess::Color::WHITE) ? whiteClockMs : blackClockMs;
+    clock = clockLeft(board_.sideToMove());  // Charge the turn in progress so the clocks stay where they stopped
+
+    turnTimer.invalidate();
+    flagTimer.stop();
+}
+
+bool GameController::punchClock() {
+    const bool whiteMoves = board_.sideToMove() == chess::Color::WHITE;
+    qint64 &clock = whiteMoves ? whiteClockMs : blackClockMs;
+
+    if (turnTimer.isValid()) {
+        const qint64 used = turnTimer.elapsed();
+        if (used >= clock) { return false; }
+        clock -= used;
+    }
+    clock += info ? info->clockIncrementMs : 0;
+
+    turnTimer.restart();  // The other side's turn starts now
+    flagTimer.start(int(std::min<qint64>(whiteMoves ? blackClockMs : whiteClockMs, INT_MAX)));
+    return true;
+}
+
+void GameController::checkFlag() {
+    if (state_ != State::AwaitingUser && state_ != State::AwaitingEngine) { return; }  // The game ended first
+
+    const qint64 left = clockLeft(board_.sideToMove());
+    if (left > 0) { flagTimer.start(int(left)); }  // Timers may fire a little early
+    else { loseOnTime(); }
+}
+
+void GameController::loseOnTime() {
+    const bool whiteFlagged = board_.sideToMove() == chess::Color::WHITE;
+    info->writeTime(info->username, whiteFlagged ? "w" : "b");
+    gameOver("Time", whiteFlagged ? "Black wins on time!" : "White wins on time!");
+}
+
+qint64 GameController::clockLeft(chess::Color color) const {
+    qint64 left = (color == chess::Color::WHITE) ? whiteClockMs : blackClockMs;
+    if (turnTimer.isValid() && board_.sideToMove() == color) { left -= turnTimer.elapsed(); }
+
+    return std::max<qint64>(0, left);
+}
+
+SearchLimits GameController::searchLimits() const {
+    const int inc = info ? info->clockIncrementMs : 0;
+    return SearchLimits::clocks(clockLeft(chess::Color::WHITE), clockLeft(chess::Color::BLACK), inc, inc);
+}
+
+// Cache key for the engine's answer in the current position at the current strength and clock
+EngineCache::Key GameController::cacheKey() const {
+    EngineCache::Key key;
+    key.hash = board_.hash();
+    key.elo = quint16(info->elo);
+    key.budget = EngineCache::budgetBucket(searchLimits(), board_.sideToMove() == chess::Color::WHITE);
+    return key;
+}
+
+void GameController::gameOver(const QString& title, const QString& message) {
+    // Over before anything is shown: moves, late engine answers and the flag are ignored from here, and the engine goes back to
+    // the pool, which drops any search still running for the finished game
+    state_ = State::GameOver;
+    releaseEngine();
+    stopClocks();
+
+    // The result is shown from the event loop rather than inside the click or engine callback that ended the game
+    QMetaObject::invokeMethod(this, [this, title, message]() { finishGame(title, message); }, Qt::QueuedConnection);
+}
+
+void GameController::finishGame(const QString& title, const QString& message) {
+    emit gameEnded(title, message);  // Over the final position
+
+    engineInfo_ = EngineInfo();
+    resetClocks();
+
+    // Reset board_ data
+    board_ = chess::Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    reviewPly = 0;
+    resetThreefold();
+    generateLegalMoves();  // All legal moves for the fresh board
+
+    emit movesCleared(false, 1);  // The standard start
+    emit positionChanged();
+    emit evaluationChanged();
+
+    emit nextGameNeeded();  // Still GameOver until the view calls startGame
+}
@@ -0,0 +1,118 @@
+#ifndef GAMECONTROLLER_H
+#define GAMECONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <array>
+#include "chess.hpp"
+#include "userinformation.h"
+#include "ucireader.h"
+#include "runstockfish.h"
+#include "enginecache.h"
+
+// The game apart from the widget that shows it: the position, whose turn it is, the clocks, the hand-off to the book, cache and
+// engine, and how the game ends. ChessBoard forwards the user's clicks as moves and repaints from the signals; nothing here paints.
+class GameController : public QObject {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
+
+    public:
+        // Whose turn the game is waiting for; the user's moves are only taken in AwaitingUser (play) and Reviewing
+        enum class State { AwaitingUser, AwaitingEngine, GameOver, Reviewing };
+
+        explicit GameController(QObject *parent = nullptr);
+
+        void setInfo(UserInformation* i);
+        void startGame();  // Enter the mode picked in UserInformation; the computer moves right away if it has white
+
+        State state() const { return state_; }
+        const chess::Board& board() const { return board_; }
+        quint64 targetsFrom(chess::Square square);  // Bitboard (chess::Square bits) of the squares the piece on square can move to
+
+        bool readyForUser() const;  // True if the user may move now
+        void retryComputerMove();  // Ask again on a computer turn whose search failed or never started (the board calls it on a click)
+        bool userMove(chess::Square from, chess::Square to);  // Castles go to the rook square; false if the move is not legal
+        void reviewStep(bool forward);  // One ply back or forward; forward past the last ply ends the review
+
+        qint64 clockLeft(chess::Color color) const;  // Remaining time including the turn in progress
+        bool clockRunning() const { return turnTimer.isValid(); }
+        const EngineInfo& engineInfo() const { return engineInfo_; }  // Latest info line from the engine; depth 0 until the first search reports
+
+        void loadPosition(const std::string& fen);  // Set up a position without playing it (boardbench); emits nothing
+
+    public slots:
+        void onEngineMove(const QString& move);  // Stockfish finished searching; play its move
+        void onEngineInfo(const EngineInfo& info);  // Live search progress for the evaluation bar
+        void onEngineRestarted(StockfishEngine* engine);  // The pool brought a crashed engine back; repeat the search it lost
+
+    signals:
+        void positionChanged();  // board() changed: a move, a take back or a new game
+        void computerMoved(chess::Square to);  // After its positionChanged; where the computer's piece went (the rook square for castles)
+        void evaluationChanged();  // engineInfo() changed
+        void engineLeased(StockfishEngine* engine);  // A game or review took an engine from the pool; its connections end when it goes back
+
+        // Move history for the move list panel; one signal per ply, so the listener never re-derives the game
+        void movePlayed(const QString& san);
+        void moveTakenBack();  // Review stepped back one ply
+        void movesCleared(bool blackFirst, int firstMove);  // New game or review; the side and move number of its start position
+
+        // Both come from the event loop after the game is already over (state GameOver, engine released, clocks stopped)
+        void gameEnded(const QString& title, const QString& message);  // Show the result; the board is reset once the slot returns
+        void nextGameNeeded();  // After the reset; the view prompts for the next game and calls startGame
+
+    private:
+        UserInformation* info = nullptr;
+        State state_ = State::AwaitingUser;
+        chess::Board board_;
+
+        chess::Movelist legalMoves;  // All legal moves on the board
+        std::array<quint64, 64> movesFrom{};  // Bitboard of legal targets for each from square; rebuilt with legalMoves
+        quint64 movesHash = 0;  // board_.hash() of the position legalMoves belongs to
+        bool movesValid = false;
+        void generateLegalMoves();  // Fill legalMoves and movesFrom for board_; a no-op while the position is unchanged
+
+        size_t reviewPly = 0;  // Plies of info->reviewMoves played on board_
+        EngineInfo engineInfo_;
+
+        // Game clocks; they start on white's first move and the mover is charged (plus increment) on every move
+        qint64 whiteClockMs, blackClockMs;
+        QElapsedTimer turnTimer;  // Time the side to move has used on this turn
+        QTimer flagTimer;  // Single shot, due when the side to move runs out of time
+        void resetClocks();
+        void stopClocks();  // Freeze both clocks where the game ended
+        bool punchClock();  // Call before board_.makeMove; false, with nothing charged, if the mover's flag has fallen
+        void checkFlag();  // flagTimer fired
+        void loseOnTime();  // The side to move lost on time; record it and end the game
+        SearchLimits searchLimits() const;  // Both clocks, for the engine's time manager
+
+        EngineCache::Key searchKey;  // Cache key of the position the engine is searching
+        EngineCache::Key cacheKey() const;
+
+        // Used to track threefold repitition
+        bool threeBool = false;
+        std::vector<std::string> threeMoveStale, threeMoveCastle;
+        void resetThreefold();
+
+        // Game flow; moves are applied the moment they are known (click, book, cache or stockfish), there are no timed re-entries
+        bool playMove(chess::Square from, chess::Square to);
+        void advance();  // After every move: game over, computer's turn or user's turn
+        bool checkGameOver();
+        void requestComputerMove();  // Book, then cache, then an asynchronous stockfish search
+        void playComputerMove(const QString& move);  // uci
+        void endReview();  // The result of the reviewed game, as it was recorded
+
+        // Each game against the computer leases its engine from info->enginePool with the play profile, each review with the
+        // analysis profile; either is handed back when it ends
+        void leaseEngine(const EngineProfile& profile);
+        void releaseEngine();
+
+        static constexpr int analysisMs = 5000;  // Search time for each reviewed position
+        void analysePosition();  // Review: evaluate board_ for the evaluation bar; no move is played
+
+        // End the game now and queue finishGame, which emits gameEnded, resets the board and emits nextGameNeeded
+        void gameOver(const QString& title, const QString& message);
+        void finishGame(const QString& title, const QString& message);
+};
+
+#endif
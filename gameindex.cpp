@@ -0,0 +1,118 @@
+#include "gameindex.h"
+#include <fstream>
+#include <cstring>
+
+namespace {
+    // File layout: magic, nextGame, then the entries back to back
+    const char indexMagic[8] = {'C', 'H', 'E', 'S', 'S', 'I', 'D', 'X'};
+    constexpr std::streamoff headerSize = sizeof(indexMagic) + sizeof(std::uint64_t);
+}
+
+bool GameIndex::open(const std::string& gamesPath) {
+    gamesPath_ = gamesPath;
+    indexPath_ = gamesPath + ".idx";
+    entries_.clear();
+    nextGame_ = GameRecord::startOffset;
+
+    std::ifstream games(gamesPath_, std::ios::binary);
+    if (!games.is_open()) { return false; }
+
+    if (!load()) {
+        rebuild();
+        save();
+    }
+    saved_ = entries_.size();
+    return true;
+}
+
+// Trust the index only if the games file ends where the index says, or holds an unfinished game there
+bool GameIndex::load() {
+    std::ifstream in(indexPath_, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) { return false; }
+
+    const std::streamoff size = in.tellg();
+    if (size < headerSize || (size - headerSize) % std::streamoff(sizeof(Entry)) != 0) { return false; }
+
+    char magic[sizeof(indexMagic)];
+    in.seekg(0);
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&nextGame_), sizeof(nextGame_));
+    if (!in || std::memcmp(magic, indexMagic, sizeof(magic)) != 0) { return false; }
+
+    entries_.resize(size_t((size - headerSize) / std::streamoff(sizeof(Entry))));
+    in.read(reinterpret_cast<char*>(entries_.data()), std::streamsize(entries_.size() * sizeof(Entry)));
+
+    std::ifstream games(gamesPath_, std::ios::binary | std::ios::ate);
+    const std::uint64_t gamesSize = std::uint64_t(games.tellg());
+    bool valid = in && nextGame_ >= std::uint64_t(GameRecord::startOffset) && nextGame_ <= gamesSize;
+    if (valid && nextGame_ < gamesSize) {
+        GameRecord::Header header{};
+        games.seekg(std::streamoff(nextGame_));
+        games.read(reinterpret_cast<char*>(&header), sizeof(header));
+        valid = games && header.ending == GameRecord::InProgress;
+    }
+
+    if (!valid) {
+        entries_.clear();
+        nextGame_ = GameRecord::startOffset;
+    }
+    return valid;
+}
+
+void GameIndex::rebuild() {
+    std::ifstream in(gamesPath_, std::ios::binary | std::ios::ate);
+    const std::uint64_t size = std::uint64_t(in.tellg());
+
+    std::uint64_t offset = GameRecord::startOffset;
+    GameRecord::Header header{};
+    while (offset + sizeof(header) <= size) {
+        in.seekg(std::streamoff(offset));
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || header.ending == GameRecord::InProgress) { break; }  // Only the last game can be unfinished
+
+        const std::uint32_t length = GameRecord::headerSize(header) + 2 * std::uint32_t(header.plies);
+        if (offset + length > size) { break; }  // Cut short
+
+        entries_.push_back({offset, length, header.result, header.color, header.elo});
+        offset += length;
+    }
+    nextGame_ = offset;
+}
+
+void GameIndex::save() const {
+    std::ofstream out(indexPath_, std::ios::binary | std::ios::trunc);
+    out.write(indexMagic, sizeof(indexMagic));
+    out.write(reinterpret_cast<const char*>(&nextGame_), sizeof(nextGame_));
+    out.write(reinterpret_cast<const char*>(entries_.data()), std::streamsize(entries_.size() * sizeof(Entry)));
+}
+
+void GameIndex::add(std::uint64_t offset, const GameRecord::Header& header, std::uint32_t length, bool sync) {
+    entries_.push_back({offset, length, header.result, header.color, header.elo});
+    nextGame_ = offset + length;
+    if (sync) { this->sync(); }
+}
+
+void GameIndex::sync() {
+    if (saved_ == entries_.size()) { return; }
+
+    // Append the new entries and patch nextGame in the header; the rest of the index is not touched
+    std::fstream out(indexPath_, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out.is_open()) { save(); }
+    else {
+        out.seekp(0, std::ios::end);
+        out.write(reinterpret_cast<const char*>(entries_.data() + saved_), std::streamsize((entries_.size() - saved_) * sizeof(Entry)));
+        out.seekp(sizeof(indexMagic));
+        out.write(reinterpret_cast<const char*>(&nextGame_), sizeof(nextGame_));
+    }
+    saved_ = entries_.size();
+}
+
+bool GameIndex::readGame(int game, GameRecord& record) const {
+    const Entry& entry = at(game);
+
+    std::ifstream in(gamesPath_, std::ios::binary);
+    std::string bytes(entry.length, '\0');
+    in.seekg(std::streamoff(entry.offset));
+    in.read(&bytes[0], entry.length);
+    return in && GameRecord::parse(bytes, record);
+}
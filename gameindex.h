@@ -0,0 +1,47 @@
+#ifndef GAMEINDEX_H
+#define GAMEINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "gamerecord.h"
+
+// Offset index over a user's games file, kept in "<games file>.idx" next to it. One fixed size entry per finished game says
+// where it is and how it ended, so a game can be listed or loaded with a single seek however long the history is.
+// The index is appended to as games finish (GameWriter) and rebuilt from the games file if it is missing or out of step.
+class GameIndex {
+    public:
+        struct Entry {
+            std::uint64_t offset;  // Start of the game's header
+            std::uint32_t length;  // Header, start position and moves
+            std::uint8_t result;  // GameRecord::Result
+            std::uint8_t color;  // GameRecord::Color
+            std::int16_t elo;  // 1 for a friend, -1 if unknown
+        };
+        static_assert(sizeof(Entry) == 16, "index entries are stored as raw 16 byte records");
+
+        bool open(const std::string& gamesPath);  // Load the index, rebuilding it if it does not match the games file
+        int count() const { return int(entries_.size()); }
+        const Entry& at(int game) const { return entries_.at(game); }  // 0 based
+        bool readGame(int game, GameRecord& record) const;  // One seek and one read
+
+        // Where the next game's header goes (or where the unfinished game's header is)
+        std::uint64_t nextGame() const { return nextGame_; }
+
+        // A game ended; the next starts right after it. Bulk writers (PGN import) pass sync = false and call sync() once per batch.
+        void add(std::uint64_t offset, const GameRecord::Header& header, std::uint32_t length, bool sync = true);
+        void sync();  // Append the entries not yet in the index file
+
+    private:
+        std::string gamesPath_;
+        std::string indexPath_;
+        std::vector<Entry> entries_;
+        std::uint64_t nextGame_ = GameRecord::startOffset;
+        size_t saved_ = 0;  // Entries already in the index file
+
+        bool load();
+        void rebuild();  // Walks the game headers, skipping over the moves
+        void save() const;
+};
+
+#endif
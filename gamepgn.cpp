@@ -0,0 +1,188 @@
+#include "gamepgn.h"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace {
+    // PGN result token for a game recorded from the user's side
+    const char* resultToken(const GameRecord::Header& header) {
+        const bool white = header.color != GameRecord::Black;  // A quit game has no color; it is written from White's side
+        if (header.result == GameRecord::Win)  { return white ? "1-0" : "0-1"; }
+        if (header.result == GameRecord::Loss) { return white ? "0-1" : "1-0"; }
+        if (header.result == GameRecord::Draw) { return "1/2-1/2"; }
+        return "*";
+    }
+
+    const char* terminationTag(std::uint8_t ending) {
+        if (ending == GameRecord::Exit || ending == GameRecord::Quit) { return "abandoned"; }
+        if (ending == GameRecord::Adjudicated)                        { return "adjudication"; }
+        if (ending == GameRecord::Time)                               { return "time forfeit"; }
+        return "normal";
+    }
+
+    // Collects one game at a time from the stream parser
+    class ImportVisitor : public chess::pgn::Visitor {
+        public:
+            ImportVisitor(const std::string& username, GameWriter& writer) : username_(username), writer_(writer) {}
+
+            int imported = 0;
+
+            void startPgn() override {
+                game_ = GameRecord();
+                white_.clear();
+                black_.clear();
+                whiteElo_.clear();
+                blackElo_.clear();
+                result_ = "*";
+                termination_.clear();
+                fen_.clear();
+                bad_ = false;
+                started_ = false;
+            }
+
+            void header(std::string_view key, std::string_view value) override {
+                if (key == "White")         { white_ = value; }
+                else if (key == "Black")    { black_ = value; }
+                else if (key == "WhiteElo") { whiteElo_ = value; }
+                else if (key == "BlackElo") { blackElo_ = value; }
+                else if (key == "Result")   { result_ = value; }
+                else if (key == "Termination") { termination_ = value; }
+                else if (key == "FEN")      { fen_ = value; }
+            }
+
+            void startMoves() override {
+                started_ = true;
+                board_ = fen_.empty() ? chess::Board() : chess::Board(fen_);
+                if (!fen_.empty() && board_.getFen() != chess::Board().getFen()) {
+                    game_.header.flags |= GameRecord::hasStartPosition;
+                    game_.start = chess::Board::Compact::encode(board_);
+                }
+            }
+
+            void move(std::string_view san, std::string_view) override {
+                if (bad_) { return; }
+
+                // parseSan throws on most bad input but can hand back a garbage move for some, so the result is checked against the legal moves
+                chess::Move move = chess::Move::NO_MOVE;
+                try { move = chess::uci::parseSan(board_, san); } catch (const std::exception&) {}
+                chess::movegen::legalmoves(legal_, board_);
+
+                // A move that does not parse, or a game too long for the 16 bit ply count, is skipped whole
+                if (std::find(legal_.begin(), legal_.end(), move) == legal_.end() || game_.moves.size() == 0xFFFF) {
+                    bad_ = true;
+                    skipPgn(true);
+                    return;
+                }
+                board_.makeMove(move);
+                game_.moves.push_back(move);
+            }
+
+            void endPgn() override {
+                if (bad_) { return; }
+                if (!started_) { startMoves(); }  // Only headers
+
+                GameRecord::Header& h = game_.header;
+                const bool userBlack = black_ == username_ && white_ != username_;
+                h.color = userBlack ? GameRecord::Black : GameRecord::White;
+
+                // The opponent's Elo; a friend is how our own exports name the other player
+                const std::string& opponent = userBlack ? white_ : black_;
+                const std::string& opponentElo = userBlack ? whiteElo_ : blackElo_;
+                h.elo = -1;
+                if (opponent == "Friend") { h.elo = 1; }
+                else {
+                    try { h.elo = std::int16_t(std::stoi(opponentElo)); } catch (...) {}
+                }
+
+                // Result from the user's side; how the game ended comes from the final position where the board shows it
+                const bool whiteWon = result_ == "1-0", blackWon = result_ == "0-1";
+                if (result_ == "1/2-1/2")                                                  { h.result = GameRecord::Draw; }
+                else if ((whiteWon && h.color == GameRecord::White) || (blackWon && userBlack)) { h.result = GameRecord::Win; }
+                else if (whiteWon || blackWon)                                              { h.result = GameRecord::Loss; }
+                else                                                                        { h.result = GameRecord::Undetermined; }
+
+                switch (board_.isGameOver().first) {
+                    case chess::GameResultReason::CHECKMATE:             h.ending = GameRecord::Checkmate; break;
+                    case chess::GameResultReason::STALEMATE:             h.ending = GameRecord::Stalemate; break;
+                    case chess::GameResultReason::INSUFFICIENT_MATERIAL: h.ending = GameRecord::InsufficientMaterial; break;
+                    case chess::GameResultReason::FIFTY_MOVE_RULE:       h.ending = GameRecord::FiftyMove; break;
+                    case chess::GameResultReason::THREEFOLD_REPETITION:  h.ending = GameRecord::Threefold; break;
+                    default: h.ending = h.result == GameRecord::Undetermined ? GameRecord::Exit : GameRecord::Adjudicated; break;
+                }
+                if (h.ending == GameRecord::Adjudicated && termination_ == "time forfeit") { h.ending = GameRecord::Time; }
+
+                if (writer_.writeGame(game_)) { imported++; }
+            }
+
+        private:
+            const std::string& username_;
+            GameWriter& writer_;
+
+            GameRecord game_;
+            chess::Board board_;
+            chess::Movelist legal_;
+            std::string white_, black_, whiteElo_, blackElo_, result_, termination_, fen_;
+            bool bad_ = false;
+            bool started_ = false;
+    };
+}
+
+void GamePgn::writeGame(const GameRecord& game, int round, const std::string& username, std::ostream& out) {
+    const GameRecord::Header& h = game.header;
+    const std::string opponent = h.elo == 1 ? "Friend" : h.elo > 0 ? "Stockfish " + std::to_string(h.elo) : "?";
+    const bool userBlack = h.color == GameRecord::Black;
+    const char* result = resultToken(h);
+
+    out << "[Event \"Casual game\"]\n[Site \"?\"]\n[Date \"????.??.??\"]\n[Round \"" << round << "\"]\n";
+    out << "[White \"" << (userBlack ? opponent : username) << "\"]\n";
+    out << "[Black \"" << (userBlack ? username : opponent) << "\"]\n";
+    out << "[Result \"" << result << "\"]\n";
+    if (h.elo > 1) { out << (userBlack ? "[WhiteElo \"" : "[BlackElo \"") << h.elo << "\"]\n"; }
+    out << "[Termination \"" << terminationTag(h.ending) << "\"]\n";
+
+    chess::Board board = game.startBoard();
+    if (h.flags & GameRecord::hasStartPosition) { out << "[SetUp \"1\"]\n[FEN \"" << board.getFen() << "\"]\n"; }
+    out << '\n';
+
+    // Movetext wrapped below 80 columns
+    std::string line;
+    auto put = [&line, &out](const std::string& token) {
+        if (!line.empty() && line.size() + 1 + token.size() > 79) {
+            out << line << '\n';
+            line.clear();
+        }
+        if (!line.empty()) { line += ' '; }
+        line += token;
+    };
+
+    for (size_t i = 0; i < game.moves.size(); i++) {
+        const bool whiteToMove = board.sideToMove() == chess::Color::WHITE;
+        if (whiteToMove || i == 0) { put(std::to_string(board.fullMoveNumber()) + (whiteToMove ? "." : "...")); }
+
+        put(chess::uci::moveToSan(board, game.moves[i]));
+        board.makeMove(game.moves[i]);
+    }
+    put(result);
+    out << line << "\n\n";
+}
+
+int GamePgn::exportGames(const GameIndex& index, const std::string& username, std::ostream& out) {
+    int written = 0;
+    GameRecord game;
+    for (int i = 0; i < index.count(); i++) {
+        if (!index.readGame(i, game)) { continue; }
+        writeGame(game, i + 1, username, out);
+        written++;
+    }
+    return written;
+}
+
+int GamePgn::importGames(std::istream& in, const std::string& username, GameWriter& writer, std::string* error) {
+    ImportVisitor visitor(username, writer);
+    chess::pgn::StreamParser<> parser(in);
+    const chess::pgn::StreamParserError status = parser.readGames(visitor);
+
+    writer.flush();  // The last batch and its index entries
+    if (error && status.hasError() && status != chess::pgn::StreamParserError::NotEnoughData) { *error = status.message(); }
+    return visitor.imported;
+}
@@ -0,0 +1,24 @@
+#ifndef GAMEPGN_H
+#define GAMEPGN_H
+
+#include <iosfwd>
+#include <string>
+#include "gameindex.h"
+#include "gamewriter.h"
+
+// PGN export and import for a user's games, so they can be moved to and from standard chess tools.
+// Both directions stream one game at a time: export decodes a game and writes it out, import goes through chess::pgn::StreamParser's
+// visitor and hands each game to GameWriter, so memory stays bounded for multi GB files.
+class GamePgn {
+    public:
+        // Every finished game in the index, in order; returns how many were written
+        static int exportGames(const GameIndex& index, const std::string& username, std::ostream& out);
+
+        // Games where username is White or Black are recorded from that side, any other game from White's. Games with a move that
+        // does not parse are skipped. Returns how many were added; error receives the parser's message if the file is malformed.
+        static int importGames(std::istream& in, const std::string& username, GameWriter& writer, std::string* error = nullptr);
+
+        static void writeGame(const GameRecord& game, int round, const std::string& username, std::ostream& out);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "gamerecord.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+constexpr char GameRecord::magic[8];
+
+chess::Board GameRecord::startBoard() const {
+    if (header.flags & hasStartPosition) { return chess::Board::Compact::decode(start); }
+    return chess::Board();  // Standard start position
+}
+
+std::uint32_t GameRecord::headerSize(const Header& header) {
+    return sizeof(Header) + ((header.flags & hasStartPosition) ? sizeof(chess::PackedBoard) : 0);
+}
+
+std::uint32_t GameRecord::size() const { return headerSize(header) + 2 * std::uint32_t(moves.size()); }
+
+bool GameRecord::parse(const std::string& bytes, GameRecord& game) {
+    if (bytes.size() < sizeof(Header)) { return false; }
+    std::memcpy(&game.header, bytes.data(), sizeof(Header));
+
+    const size_t at = headerSize(game.header);
+    if (bytes.size() < at + 2 * size_t(game.header.plies)) { return false; }
+    if (game.header.flags & hasStartPosition) { std::memcpy(game.start.data(), bytes.data() + sizeof(Header), game.start.size()); }
+
+    // The decode loop: every ply is the move's own 16 bit encoding
+    game.moves.resize(game.header.plies);
+    for (size_t i = 0; i < game.moves.size(); i++) {
+        std::uint16_t raw;
+        std::memcpy(&raw, bytes.data() + at + 2 * i, 2);
+        game.moves[i] = chess::Move(raw);
+    }
+    return true;
+}
+
+std::string GameRecord::serialize() const {
+    Header h = header;
+    h.plies = std::uint16_t(moves.size());
+
+    std::string bytes(reinterpret_cast<const char*>(&h), sizeof(h));
+    if (h.flags & hasStartPosition) { bytes.append(reinterpret_cast<const char*>(start.data()), start.size()); }
+    for (const chess::Move& move : moves) {
+        const std::uint16_t raw = move.move();
+        bytes.append(reinterpret_cast<const char*>(&raw), 2);
+    }
+    return bytes;
+}
+
+std::string GameRecord::info() const {
+    static const char* endings[] = { "Undetermined", "Checkmate", "Stalemate", "Insufficient Material", "Threefold Repetition",
+                                     "Fifty Move Rule", "Undetermined", "Undetermined", "Adjudicated", "Time Forfeit" };
+    static const char* results[] = { "Exit", "Win", "Loss", "Draw" };
+
+    if (header.ending == Quit) { return "Undetermined | User Quit"; }  // Written at login, before the color was known
+
+    const std::string color = header.color == White ? "White" : "Black";
+    const std::string vs = header.elo == 1 ? "Friend" : header.elo > 0 ? std::to_string(header.elo) + " Elo" : "Unknown";
+    return std::string(endings[std::min<int>(header.ending, Time)]) + " | " + color + " User " + results[std::min<int>(header.result, 3)] + " | vs. " + vs;
+}
+
+GameRecord::Header GameRecord::fromInfo(const std::string& info) {
+    Header h{};
+    auto has = [&info](const char* text) { return info.find(text) != std::string::npos; };
+
+    if (has("Quit"))                       { h.ending = Quit; }
+    else if (has("Exit"))                  { h.ending = Exit; }
+    else if (has("Checkmate"))             { h.ending = Checkmate; }
+    else if (has("Stalemate"))             { h.ending = Stalemate; }
+    else if (has("Insufficient Material")) { h.ending = InsufficientMaterial; }
+    else if (has("Threefold Repetition"))  { h.ending = Threefold; }
+    else if (has("Fifty Move Rule"))       { h.ending = FiftyMove; }
+    else if (has("Adjudicated"))           { h.ending = Adjudicated; }
+    else if (has("Time Forfeit"))          { h.ending = Time; }
+    else                                   { h.ending = Exit; }  // Finished, but with an ending this version does not know
+
+    if (has("Win"))       { h.result = Win; }
+    else if (has("Loss")) { h.result = Loss; }
+    else if (has("Draw")) { h.result = Draw; }
+    else                  { h.result = Undetermined; }
+
+    if (has("White"))      { h.color = White; }
+    else if (has("Black")) { h.color = Black; }
+    else                   { h.color = Unknown; }
+
+    h.elo = -1;
+    const size_t vs = info.find("vs. ");
+    if (has("Friend")) { h.elo = 1; }
+    else if (vs != std::string::npos) {
+        try { h.elo = std::int16_t(std::stoi(info.substr(vs + 4))); } catch (...) {}
+    }
+    return h;
+}
+
+namespace {
+    std::string trimmed(const std::string& str) {
+        auto begin = str.find_first_not_of(" \t\r\n");
+        auto end = str.find_last_not_of(" \t\r\n");
+        return (begin == std::string::npos) ? "" : str.substr(begin, end - begin + 1);
+    }
+
+    // "e2 pawn e4, e7 pawn e5, " to moves, replayed from the start position
+    std::vector<chess::Move> replayText(const std::string& text) {
+        std::vector<chess::Move> moves;
+        chess::Board board;
+        chess::Movelist legal;
+
+        std::istringstream in(text);
+        std::string token;
+        while (std::getline(in, token, ',')) {
+            const std::string move = trimmed(token);
+            if (move.size() < 7) { continue; }  // "e2 pawn e4" at the shortest is "e2 king e4"
+
+            const bool promotes = move.substr(3, 4) == "pawn" && (move.back() == '1' || move.back() == '8');  // The Gui always queens
+            const std::string uci = move.substr(0, 2) + move.substr(move.size() - 2, 2) + (promotes ? "q" : "");
+
+            chess::movegen::legalmoves(legal, board);
+            const chess::Move played = chess::uci::uciToMove(board, uci);  // Also turns e1g1 into chess.hpp's king takes rook
+            if (std::find(legal.begin(), legal.end(), played) == legal.end()) { break; }
+
+            board.makeMove(played);
+            moves.push_back(played);
+        }
+        return moves;
+    }
+}
+
+bool GameRecord::convertText(const std::string& textPath, const std::string& binaryPath) {
+    std::ifstream in(textPath);
+    if (!in.is_open()) { return false; }
+
+    std::string bytes(magic, sizeof(magic));
+    std::string line, unfinished;
+    while (std::getline(in, line)) {
+        if (line.rfind(">>", 0) != 0) { continue; }  // Header lines
+
+        const size_t open = line.find('(');
+        GameRecord game;
+        if (open == std::string::npos) {
+            unfinished = line.substr(2);  // Only the last such line can still be in progress
+            continue;
+        }
+        game.header = fromInfo(line.substr(open + 1, line.rfind(')') - open - 1));
+        game.moves = replayText(line.substr(2, open - 2));
+        bytes += game.serialize();
+        unfinished.clear();
+    }
+
+    // A game the program never got to end; the next login records it as quit
+    GameRecord last;
+    last.moves = replayText(unfinished);
+    if (!last.moves.empty()) {
+        last.header.ending = InProgress;
+        last.header.color = Unknown;
+        last.header.elo = -1;
+        bytes += last.serialize();
+    }
+
+    std::ofstream out(binaryPath, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), std::streamsize(bytes.size()));
+    return bool(out);
+}
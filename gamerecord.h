@@ -0,0 +1,53 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chess.hpp"
+
+// Binary layout of a user's games file: an 8 byte magic, then the games back to back. Each game is a Header, the start position
+// as a chess::PackedBoard if it is not the standard one, then one raw 16 bit chess::Move per ply. A move costs 2 bytes instead of
+// the ~15 of the old "e2 pawn e4, " text, and replaying a game is a decode loop over makeMove.
+struct GameRecord {
+    enum Ending : std::uint8_t { InProgress, Checkmate, Stalemate, InsufficientMaterial, Threefold, FiftyMove, Exit, Quit,
+                                 Adjudicated,  // Decided off the board (resignation, agreement); only imported games
+                                 Time };  // A flag fell
+    enum Result : std::uint8_t { Undetermined, Win, Loss, Draw };  // For the user
+    enum Color : std::uint8_t { Unknown, White, Black };  // The user's color
+
+    struct Header {
+        std::uint8_t ending;  // InProgress until the result is written
+        std::uint8_t result;
+        std::uint8_t color;
+        std::uint8_t flags;
+        std::int16_t elo;  // Opponent; 1 for a friend, -1 if unknown
+        std::uint16_t plies;  // Patched in with the result; recomputed from the file length for a game that never got one
+    };
+    static_assert(sizeof(Header) == 8, "headers are stored as raw 8 byte records");
+
+    static constexpr std::uint8_t hasStartPosition = 1;  // flags: a PackedBoard follows the header
+    static constexpr char magic[8] = {'C', 'H', 'E', 'S', 'S', 'G', 'M', '1'};
+    static constexpr std::streamoff startOffset = sizeof(magic);  // First game
+
+    Header header{};
+    chess::PackedBoard start{};  // Only meaningful with hasStartPosition
+    std::vector<chess::Move> moves;
+
+    chess::Board startBoard() const;
+    std::uint32_t size() const;  // Bytes on disk
+
+    static std::uint32_t headerSize(const Header& header);  // Header plus start position
+    static bool parse(const std::string& bytes, GameRecord& game);  // One game as stored; false if it is cut short
+    std::string serialize() const;
+
+    // The game info as the text records wrote it (eg: "Checkmate | White User Win | vs. 1500 Elo"); review mode reads it
+    std::string info() const;
+    static Header fromInfo(const std::string& info);
+
+    // One off conversion of a text record file ("username", "---", then ">> e2 pawn e4, ... (info)" per game) into a games
+    // file. Moves are replayed to turn them into chess::Moves; a game stops at the first one that does not fit its position.
+    static bool convertText(const std::string& textPath, const std::string& binaryPath);
+};
+
+#endif
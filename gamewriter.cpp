@@ -0,0 +1,131 @@
+#include "gamewriter.h"
+#include <algorithm>
+#include <filesystem>
+
+GameWriter::GameWriter(Durability durability, int flushEvery)
+    : durability_(durability), flushEvery_(std::max(1, flushEvery)) {
+        pending_.reserve(512);  // A long game's moves between flushes
+}
+
+GameWriter::~GameWriter() { flush(); }
+
+bool GameWriter::open(const std::string& path) {
+    if (file_.is_open() && path == path_) { return true; }
+
+    // Switching files: the old one gets its pending moves first
+    flush();
+    if (file_.is_open()) { file_.close(); }
+    path_.clear();
+
+    // A new file starts with the magic
+    if (!std::ifstream(path).is_open()) {
+        std::ofstream create(path, std::ios::binary);
+        create.write(GameRecord::magic, sizeof(GameRecord::magic));
+    }
+
+    file_.clear();
+    file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file_.is_open() || !index_.open(path)) { return false; }
+
+    file_.seekp(0, std::ios::end);
+    end_ = std::uint64_t(file_.tellp());
+    inGame_ = end_ > index_.nextGame();  // Bytes past the last finished game are an unfinished one
+    path_ = path;
+    return true;
+}
+
+void GameWriter::setDurability(Durability durability, int flushEvery) {
+    durability_ = durability;
+    flushEvery_ = std::max(1, flushEvery);
+}
+
+void GameWriter::beginGame(GameRecord::Color color, int elo) {
+    GameRecord::Header header{};
+    header.ending = GameRecord::InProgress;
+    header.color = color;
+    header.elo = std::int16_t(elo);
+
+    pending_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    inGame_ = true;
+}
+
+void GameWriter::writeMove(chess::Move move) {
+    const std::uint16_t raw = move.move();
+    pending_.append(reinterpret_cast<const char*>(&raw), sizeof(raw));
+    pendingMoves_++;
+
+    if (durability_ == Durability::EveryMove ||
+        (durability_ == Durability::EveryNMoves && pendingMoves_ >= flushEvery_)) {
+            flush();
+    }
+}
+
+void GameWriter::writeResult(GameRecord::Ending ending, GameRecord::Result result) {
+    if (!inGame_ || !flush()) { return; }
+    inGame_ = false;
+
+    // The header was written with the first move; fill in how the game ended and how long it is
+    const std::uint64_t start = index_.nextGame();
+    GameRecord::Header header{};
+    file_.seekg(std::streamoff(start));
+    file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file_ || end_ - start < GameRecord::headerSize(header)) {
+        // Torn header (the program died before the first move was whole); nothing of the game can be read back
+        file_.clear();
+        truncate(start);
+        return;
+    }
+
+    header.ending = ending;
+    header.result = result;
+    header.plies = std::uint16_t((end_ - start - GameRecord::headerSize(header)) / 2);
+    truncate(start + GameRecord::headerSize(header) + 2 * std::uint64_t(header.plies));  // Drop half a move left by a torn write
+
+    file_.seekp(std::streamoff(start));
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.flush();  // Every policy keeps finished games on disk
+
+    index_.add(start, header, GameRecord::headerSize(header) + 2 * std::uint32_t(header.plies));
+}
+
+bool GameWriter::writeGame(const GameRecord& game) {
+    if (inGame_ || game.header.ending == GameRecord::InProgress) { return false; }  // Games follow the unfinished one otherwise
+
+    // Written in batches; the index entry goes in now and reaches the index file with the batch
+    const std::string bytes = game.serialize();
+    index_.add(end_ + pending_.size(), game.header, std::uint32_t(bytes.size()), false);
+    pending_ += bytes;
+
+    if (pending_.size() >= (1 << 20)) { return flush(); }  // Memory stays bounded however many games come in
+    return true;
+}
+
+bool GameWriter::flush() {
+    if (pending_.empty()) { return true; }
+    if (!file_.is_open()) { return false; }  // Keep the bytes until a file is open
+
+    file_.seekp(std::streamoff(end_));
+    file_.write(pending_.data(), std::streamsize(pending_.size()));
+    file_.flush();  // One write call for the whole batch
+    if (!file_) { return false; }
+
+    end_ += pending_.size();
+    pending_.clear();
+    pendingMoves_ = 0;
+    index_.sync();  // After the bytes it points at
+    return true;
+}
+
+// Cut the file back to size, so the next game starts right after the last whole move instead of after a stray byte
+bool GameWriter::truncate(std::uint64_t size) {
+    if (size >= end_) { return true; }
+
+    file_.close();  // Resized by path; reopened below
+    std::error_code error;
+    std::filesystem::resize_file(path_, size, error);
+    file_.clear();
+    file_.open(path_, std::ios::binary | std::ios::in | std::ios::out);
+
+    end_ = size;  // Even if the resize failed, the next write lands here and overwrites the tail
+    return !error && file_.is_open();
+}
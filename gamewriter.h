@@ -0,0 +1,54 @@
+#ifndef GAMEWRITER_H
+#define GAMEWRITER_H
+
+#include <fstream>
+#include <string>
+#include "gameindex.h"
+
+// Appends games to a user's games file (see GameRecord) through one handle that stays open for the whole session. Moves collect
+// in memory and reach the file according to the durability policy; results always flush, so a finished game is never left in the
+// buffer. Each result also patches the game's header and adds the game to the file's GameIndex.
+class GameWriter {
+    public:
+        enum class Durability {
+            EveryMove,  // Flush after each move: nothing is lost if the program dies mid game
+            EveryNMoves,  // Flush once flushEvery moves have collected
+            GameEnd  // Only the result (or an exit) flushes
+        };
+
+        GameWriter(Durability durability = Durability::EveryNMoves, int flushEvery = 10);
+        ~GameWriter();  // Flushes whatever is pending
+
+        bool open(const std::string& path);  // Create or append to path and load its index; a no-op if it is already the open file
+        bool isOpen() const { return file_.is_open(); }
+        const std::string& path() const { return path_; }
+
+        void setDurability(Durability durability, int flushEvery = 10);
+
+        void beginGame(GameRecord::Color color, int elo);  // Header of a new game; written with its first move
+        void writeMove(chess::Move move);
+        void writeResult(GameRecord::Ending ending, GameRecord::Result result);  // Ends the game begun last (or left unfinished)
+        bool writeGame(const GameRecord& game);  // A whole finished game (PGN import); false while a game is in progress
+        bool flush();  // Hand the pending bytes to the file and bring the index up to date; false if the write failed
+
+        // True if the file holds a game without a result. Known from the index and the file length, nothing is read.
+        bool gameInProgress() const { return inGame_; }
+
+        const GameIndex& index() const { return index_; }  // Finished games of the open file
+
+    private:
+        std::fstream file_;
+        std::string path_;
+        std::uint64_t end_ = 0;  // Length of the file; every write goes here
+        GameIndex index_;
+        std::string pending_;  // Bytes not yet written to file_
+        int pendingMoves_ = 0;
+        bool inGame_ = false;
+
+        Durability durability_;
+        int flushEvery_;
+
+        bool truncate(std::uint64_t size);  // Shorten the file (and end_) to size
+};
+
+#endif
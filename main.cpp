@@ -1,132 +1,262 @@
-#include <QApplication>
-#include <QMessageBox>
-#include "mainwindow.h"
-#include "userinformation.h"
-#include "promptdialog.h"
-#include "chessboard.h"
-
-/*
-
-tasks.json: We let Qt handle the compilation
-{
-    "version": "2.0.0",
-    "tasks": [
-        {
-            "label": "Qt Build (qmake + make)",
-            "type": "shell",
-            "command": "qmake && make",
-            "group": {
-                "kind": "build",
-                "isDefault": true
-            },
-            "problemMatcher": []
-        }
-    ]
-}
-
-c_cpp_properties.json: We include the Qt paths because they are not included in the compiler
-{
-    "configurations": [
-        {
-            "name": "Win32",
-            "compilerPath": "C:/msys64/mingw64/bin/g++.exe",
-            "intelliSenseMode": "windows-gcc-x64",
-            "cStandard": "c11",
-            "cppStandard": "c++17",
-            "includePath": [
-                "${workspaceFolder}/**",
-                "C:/msys64/mingw64/include",
-                "C:/msys64/usr/include",
-                "C:/msys64/mingw64/include/QtWidgets",
-                "C:/msys64/mingw64/include/QtGui",
-                "C:/msys64/mingw64/include/QtCore",
-                "C:/Users/wscal/OneDrive/Desktop/cpp/chess/extern"
-            ],
-            "defines": [
-                "_DEBUG",
-                "UNICODE",
-                "_UNICODE"
-            ]
-        }
-    ],
-    "version": 4
-}
-
-chess.pro: qmake project file; used by qmake to help include all of the proper files during compilation
-QT += widgets
-CONFIG += c++17
-
-INCLUDEPATH += $$PWD/extern
-
-SOURCES += main.cpp \
-           mainwindow.cpp \
-           chessboard.cpp \
-           userinformation.cpp \
-           promptdialog.cpp
-
-HEADERS += mainwindow.h \
-           chessboard.h \
-           userinformation.h \
-           promptdialog.h \
-           extern/chess.hpp
-
-LIBS += -lssl -lcrypto
-
-
-COMPILE CODE:
-cd /c/Users/wscal/OneDrive/Desktop/cpp/chess           // Navigate to the correct directory
-rm -f release/chess.exe                                // Delete the old executable to compile the new one (incase there are any changes in the code)
-qmake                                                  // Reads chess.pro and generates new Makefiles
-mingw32-make                                           // Compile source files (.cpp -> .o)
-./release/chess.exe                                    // Execute
-
-    **If we have drastically altered the .pro file or include paths: rm -f Makefile* release/*.o release/chess.exe release/moc_* .qmake.stash
-        ^^Remove all files used in previous compile to ensure a fresh rebuild (* means all files starting or ending with, depending on its location)
-
-*/
-
-// Clarifies number of arguments for the compiler as well as setting them as strings (char pointers point to the first char of the string)
-int main(int argc, char *argv[]) {
-    QApplication a(argc, argv);  // Create the application object (which manages the event loop)
-
-    MainWindow w;  // Instantiate the MainWindow object with an implicit call to its construtor ( MainWindow w = MainWindow(); )
-    w.show();  // Display the MainWindow
-
-    int iUserChoice = -1;
-
-    // Loop until valid input
-    while (true) {
-        PromptDialog prompt("Press 1 to register or 2 to login: ", &w);
-        prompt.followParent();  // Position under main windows
-        QObject::connect(&w, &MainWindow::geometryChanged, &prompt, &PromptDialog::followParent);  // Connect the geometryChanged signal to the followParent slot
-        prompt.exec();  // Display the dialog; program will move to the next line when the OK button is clicked
-
-        bool isInt = true;
-        std::string sUserChoice = prompt.getInputText().toStdString();
-
-        // Try to convert to int; if the user typed a non int, fall through to the QMessageBox warning
-        try {
-            iUserChoice = std::stoi(sUserChoice);
-        } catch (...) { isInt = false; }
-
-        if (isInt) {
-            if (iUserChoice == 1 || iUserChoice == 2) { break; }  // Break and instantiate UserInformation outside of the loop
-            else if (iUserChoice == 0) { return 0; }  // Terminate program
-        }
-
-        QMessageBox::warning(&w, "Invalid Input", "Please enter 1 to register or 2 to login.");  // Show invalid input message, reloop
-    }
-
-    UserInformation info(iUserChoice, &w);  // Instatiate UserInformation; same as: UserInformation info = UserInformation(iUserchoice, &w)
-
-    w.board->setInfo(&info);  // Make the data in UserInformation accessible for our ChessBoard instance
-
-    info.engine = new StockfishEngine(&w);
-    if (!(info.engine->start(info.enginePath))) { qWarning("Failed to start Stockfish"); }
-
-    info.engine->markNewGame();
-    info.engine->setElo(info.elo);
-    info.running = true;
-
-    return a.exec();  // Start the Qt event loop, allowing the user to interact with the board (starts after we have finished with UserInformation)
+#include <QApplication>
+#include <QMessageBox>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStatusBar>
+#include "mainwindow.h"
+#include "userinformation.h"
+#include "promptdialog.h"
+#include "chessboard.h"
+#include "enginemetrics.h"
+#include "enginecache.h"
+#include "openingbook.h"
+
+/*
+
+tasks.json: We let Qt handle the compilation
+{
+    "version": "2.0.0",
+    "tasks": [
+        {
+            "label": "Qt Build (qmake + make)",
+            "type": "shell",
+            "command": "qmake && make",
+            "group": {
+                "kind": "build",
+                "isDefault": true
+            },
+            "problemMatcher": []
+        }
+    ]
+}
+
+c_cpp_properties.json: We include the Qt paths because they are not included in the compiler
+{
+    "configurations": [
+        {
+            "name": "Win32",
+            "compilerPath": "C:/msys64/mingw64/bin/g++.exe",
+            "intelliSenseMode": "windows-gcc-x64",
+            "cStandard": "c11",
+            "cppStandard": "c++17",
+            "includePath": [
+                "${workspaceFolder}/**",
+                "C:/msys64/mingw64/include",
+                "C:/msys64/usr/include",
+                "C:/msys64/mingw64/include/QtWidgets",
+                "C:/msys64/mingw64/include/QtGui",
+                "C:/msys64/mingw64/include/QtCore",
+                "C:/Users/wscal/OneDrive/Desktop/cpp/chess/extern"
+            ],
+            "defines": [
+                "_DEBUG",
+                "UNICODE",
+                "_UNICODE"
+            ]
+        }
+    ],
+    "version": 4
+}
+
+chess.pro: qmake project file; used by qmake to help include all of the proper files during compilation
+QT += widgets
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD/extern
+
+SOURCES += main.cpp \
+           mainwindow.cpp \
+           chessboard.cpp \
+           userinformation.cpp \
+           promptdialog.cpp
+
+HEADERS += mainwindow.h \
+           chessboard.h \
+           userinformation.h \
+           promptdialog.h \
+           extern/chess.hpp
+
+LIBS += -lssl -lcrypto
+
+
+COMPILE CODE:
+cd /c/Users/wscal/OneDrive/Desktop/cpp/chess           // Navigate to the correct directory
+rm -f release/chess.exe                                // Delete the old executable to compile the new one (incase there are any changes in the code)
+qmake                                                  // Reads chess.pro and generates new Makefiles
+mingw32-make                                           // Compile source files (.cpp -> .o)
+./release/chess.exe                                    // Execute
+
+    **If we have drastically altered the .pro file or include paths: rm -f Makefile* release/*.o release/chess.exe release/moc_* .qmake.stash
+        ^^Remove all files used in previous compile to ensure a fresh rebuild (* means all files starting or ending with, depending on its location)
+
+PAINT BENCHMARK (separate target, see boardbench.cpp):
+qmake boardbench.pro && make -f Makefile.boardbench    // Builds ./boardbench next to the game; the game's chess.pro is untouched
+    **Both targets take their sources from chess.pri; a new file goes there once, not in each .pro
+QT_QPA_PLATFORM=offscreen ./boardbench positions.fen   // Headless; prints p50 / p90 / p99 paint latency
+
+PGN TRANSFER (after login, before the review or new game is chosen):
+./release/chess.exe --import-pgn games.pgn             // Streams the file; games with a bad move are skipped
+./release/chess.exe --export-pgn mygames.pgn           // Every finished game, in the order it was played
+
+TIME CONTROL (minutes+increment seconds; a fallen flag loses the game):
+./release/chess.exe --time-control 15+10
+
+ENGINES (engine.ini holds [play], [analysis] and [pool] size=; the flags override it):
+./release/chess.exe --engines 3 --engine-set analysis.threads=8
+
+*/
+
+// Clarifies number of arguments for the compiler as well as setting them as strings (char pointers point to the first char of the string)
+int main(int argc, char *argv[]) {
+    QApplication a(argc, argv);  // Create the application object (which manages the event loop)
+
+    // Engine resources can be tuned without a rebuild: an ini file with [play] / [analysis] groups, then single values on the command line
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption configOption("engine-config", "Ini file with [play] and [analysis] engine profiles.", "file");
+    QCommandLineOption setOption("engine-set", "Override one profile value, eg: analysis.threads=8 or play.hash=auto (repeatable).", "profile.key=value");
+    QCommandLineOption enginesOption("engines", "Stockfish processes to spawn up front (default 2, so play and review keep their own).", "N");
+    QCommandLineOption bookOption("book", "Polyglot opening book for the computer's opening moves.", "file");
+    QCommandLineOption importOption("import-pgn", "Add the games in a PGN file to the user's games (read one game at a time).", "file");
+    QCommandLineOption exportOption("export-pgn", "Write all of the user's finished games to a PGN file.", "file");
+    QCommandLineOption timeControlOption("time-control", "Clock for every game, as minutes+increment seconds (default 5+3).", "minutes+seconds");
+    QCommandLineOption durabilityOption("game-durability", "When moves reach the user's games file: move, game (only at the end), or every N moves (default 10).", "move|game|N");
+    parser.addOption(configOption);
+    parser.addOption(setOption);
+    parser.addOption(enginesOption);
+    parser.addOption(bookOption);
+    parser.addOption(importOption);
+    parser.addOption(exportOption);
+    parser.addOption(durabilityOption);
+    parser.addOption(timeControlOption);
+    parser.process(a);
+
+    MainWindow w;  // Instantiate the MainWindow object with an implicit call to its construtor ( MainWindow w = MainWindow(); )
+    w.show();  // Display the MainWindow
+
+    int iUserChoice = -1;
+
+    // Loop until valid input
+    while (true) {
+        PromptDialog prompt("Press 1 to register or 2 to login: ", &w);
+        prompt.followParent();  // Position under main windows
+        QObject::connect(&w, &MainWindow::geometryChanged, &prompt, &PromptDialog::followParent);  // Connect the geometryChanged signal to the followParent slot
+        prompt.exec();  // Display the dialog; program will move to the next line when the OK button is clicked
+
+        bool isInt = true;
+        std::string sUserChoice = prompt.getInputText().toStdString();
+
+        // Try to convert to int; if the user typed a non int, fall through to the QMessageBox warning
+        try {
+            iUserChoice = std::stoi(sUserChoice);
+        } catch (...) { isInt = false; }
+
+        if (isInt) {
+            if (iUserChoice == 1 || iUserChoice == 2) { break; }  // Break and instantiate UserInformation outside of the loop
+            else if (iUserChoice == 0) { return 0; }  // Terminate program
+        }
+
+        QMessageBox::warning(&w, "Invalid Input", "Please enter 1 to register or 2 to login.");  // Show invalid input message, reloop
+    }
+
+    UserInformation info(iUserChoice, &w);  // Instatiate UserInformation; same as: UserInformation info = UserInformation(iUserchoice, &w)
+
+    // Durability of the game record; the games file is already open, the policy applies from the first move
+    if (parser.isSet(durabilityOption)) {
+        const QString policy = parser.value(durabilityOption);
+        bool isNumber = false;
+        const int every = policy.toInt(&isNumber);
+
+        if (policy == "move")           { info.setGameDurability(GameWriter::Durability::EveryMove); }
+        else if (policy == "game")      { info.setGameDurability(GameWriter::Durability::GameEnd); }
+        else if (isNumber && every > 0) { info.setGameDurability(GameWriter::Durability::EveryNMoves, every); }
+        else { qWarning("Ignoring --game-durability %s (expected move, game or a number of moves)", qPrintable(policy)); }
+    }
+
+    // Time control; the board's clocks are set from it when the board receives info
+    if (parser.isSet(timeControlOption)) {
+        const QString control = parser.value(timeControlOption);
+        bool minutesOk = false, secondsOk = false;
+        const double minutes = control.section('+', 0, 0).toDouble(&minutesOk);
+        const int seconds = control.section('+', 1).toInt(&secondsOk);
+
+        if (minutesOk && secondsOk && minutes > 0 && seconds >= 0) {
+            info.clockStartMs = int(minutes * 60 * 1000);
+            info.clockIncrementMs = seconds * 1000;
+        }
+        else { qWarning("Ignoring --time-control %s (expected minutes+increment seconds, eg: 15+10)", qPrintable(control)); }
+    }
+
+    // PGN transfer for the logged in user, before the game is chosen so imported games can be reviewed right away.
+    // Import first so an export in the same run includes the imported games.
+    if (parser.isSet(importOption)) {
+        const int imported = info.importPgn(parser.value(importOption).toStdString());
+        if (imported < 0) { qWarning("Could not read %s", qPrintable(parser.value(importOption))); }
+        else { qInfo("Imported %d games from %s", imported, qPrintable(parser.value(importOption))); }
+    }
+    if (parser.isSet(exportOption)) {
+        const int exported = info.exportPgn(parser.value(exportOption).toStdString());
+        if (exported < 0) { qWarning("Could not write %s", qPrintable(parser.value(exportOption))); }
+        else { qInfo("Exported %d games to %s", exported, qPrintable(parser.value(exportOption))); }
+    }
+
+    info.chooseGame(&w);  // Review or new game (color, opponent)
+
+    w.board->setInfo(&info);  // Make the data in UserInformation accessible for our ChessBoard instance
+
+    // Build the engine profiles and the pool size: built in defaults, then the config file, then --engine-set / --engines overrides
+    const QString configPath = parser.isSet(configOption) ? parser.value(configOption) : info.engineConfigPath;
+    if (QFileInfo::exists(configPath)) {
+        info.playProfile = EngineProfile::load(configPath, "play", info.playProfile);
+        info.analysisProfile = EngineProfile::load(configPath, "analysis", info.analysisProfile);
+        info.enginePoolSize = QSettings(configPath, QSettings::IniFormat).value("pool/size", info.enginePoolSize).toInt();
+    }
+    for (const QString &assignment : parser.values(setOption)) {
+        const QString target = assignment.section('.', 0, 0);  // "analysis"
+        const QString key = assignment.section('.', 1).section('=', 0, 0);  // "threads"
+        const QString value = assignment.section('=', 1);  // "8"
+
+        if (target == "play")          { info.playProfile.set(key, value); }
+        else if (target == "analysis") { info.analysisProfile.set(key, value); }
+        else { qWarning("Ignoring --engine-set %s (expected play.<key>=<value> or analysis.<key>=<value>)", qPrintable(assignment)); }
+    }
+
+    if (parser.isSet(enginesOption)) { info.enginePoolSize = parser.value(enginesOption).toInt(); }
+    if (info.enginePoolSize < 1) {
+        qWarning("Ignoring an engine pool size of %d (expected at least 1)", info.enginePoolSize);
+        info.enginePoolSize = 2;
+    }
+
+    // Spawn the engines up front; each game against the computer and each review leases one (GameController::leaseEngine)
+    info.enginePool = new EnginePool(info.enginePath, info.enginePoolSize, info.playProfile, &w);
+    if (info.enginePool->start() == 0) { qWarning("Failed to start Stockfish"); }
+    QObject::connect(info.enginePool, &EnginePool::engineFailed, &w, [&w]() {
+        QMessageBox::warning(&w, "Stockfish", "Stockfish keeps crashing and has been switched off. Restart the program to use it again.");
+    });
+    QObject::connect(info.enginePool, &EnginePool::restarted, w.board->game, &GameController::onEngineRestarted);  // Resume the computer's turn after a crash
+
+    // Lives as long as the event loop; the board asks it before every search
+    EngineCache cache(info.engineCachePath);
+    info.engineCache = &cache;
+
+    OpeningBook book(parser.isSet(bookOption) ? parser.value(bookOption) : info.openingBookPath);
+    if (book.isOpen()) { info.openingBook = &book; }
+
+    // Stream search progress to the metrics log and the status bar; the controller feeds the evaluation bar. Releasing a lease cuts these, so every lease connects again.
+    EngineMetrics* metrics = new EngineMetrics(info.engineMetricsPath, &w);
+    QObject::connect(w.board->game, &GameController::engineLeased, metrics, [metrics](StockfishEngine* engine) {
+        QObject::connect(engine, &StockfishEngine::infoReady, metrics, &EngineMetrics::record);
+        QObject::connect(engine, &StockfishEngine::bestMoveReady, metrics, &EngineMetrics::endSearch);
+    });
+
+    // Throughput so far, updated after every search
+    QObject::connect(metrics, &EngineMetrics::totalsChanged, &w, [&w, metrics]() {
+        w.statusBar()->showMessage(QString("Stockfish: %1 searches, %2 knps average, %3 knps peak")
+                                   .arg(metrics->searches()).arg(metrics->averageNps() / 1000).arg(metrics->peakNps() / 1000));
+    });
+
+    w.board->game->startGame();  // Plays the computer's first move if it has white
+
+    return a.exec();  // Start the Qt event loop, allowing the user to interact with the board (starts after we have finished with UserInformation)
 }
\ No newline at end of file
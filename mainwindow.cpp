@@ -1,25 +1,51 @@
-#include <QMoveEvent>
-#include "mainwindow.h"
-#include "chessboard.h"
-
-// Defining a member of the class MainWindow (MainWindow:); this member is the constructor (:MainWindow)
-MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent) {
-        board = new ChessBoard(parent);  // Instantiate the board declared in the header file
-        setCentralWidget(board);  // Create the ChessBoard widget
-        setWindowTitle("Chess | Press '0' to Exit");
-        resize(480, 600);  // Board is 480 x 480; other information displayed below the board
-}
-
-// Whenever the MainWindow is moved, emit the geometryChanged signal
-void MainWindow::moveEvent(QMoveEvent *event) {
-    QMainWindow::moveEvent(event);
-    emit geometryChanged();
-}
-
-// When the window is closed, mark the user file if they are still in a game
-MainWindow::~MainWindow() {
-    if (board->info) {
-        board->info->writeExit(board->info->username);
-    }
+#include <QMoveEvent>
+#include <QCloseEvent>
+#include <QDockWidget>
+#include <QListView>
+#include "mainwindow.h"
+#include "chessboard.h"
+#include "movelistmodel.h"
+
+// Defining a member of the class MainWindow (MainWindow:); this member is the constructor (:MainWindow)
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent) {
+        board = new ChessBoard(parent);  // Instantiate the board declared in the header file
+        setCentralWidget(board);  // Create the ChessBoard widget
+        setWindowTitle("Chess | Press '0' to Exit");
+
+        // Move list panel; the view only lays out the rows on screen, so long games cost the same as short ones
+        moveList = new MoveListModel(this);
+        QListView *moveView = new QListView(this);
+        moveView->setModel(moveList);
+        moveView->setUniformItemSizes(true);  // Every row has the same height; no per-row measuring
+        moveView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        moveView->setSelectionMode(QAbstractItemView::NoSelection);
+        moveView->setFocusPolicy(Qt::NoFocus);
+
+        QDockWidget *moveDock = new QDockWidget("Moves", this);
+        moveDock->setWidget(moveView);
+        moveDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+        addDockWidget(Qt::RightDockWidgetArea, moveDock);
+
+        connect(board->game, &GameController::movePlayed, moveList, &MoveListModel::appendMove);
+        connect(board->game, &GameController::moveTakenBack, moveList, &MoveListModel::removeLastMove);
+        connect(board->game, &GameController::movesCleared, moveList, &MoveListModel::clear);
+        connect(moveList, &QAbstractItemModel::rowsInserted, moveView, &QListView::scrollToBottom);  // Follow the game
+
+        resize(480 + 160, 600);  // Board is 480 x 480; other information displayed below the board, moves to the right
+}
+
+// Whenever the MainWindow is moved, emit the geometryChanged signal
+void MainWindow::moveEvent(QMoveEvent *event) {
+    QMainWindow::moveEvent(event);
+    emit geometryChanged();
+}
+
+// When the window is closed, mark the user file if they are still in a game. This runs from the event loop while main's
+// UserInformation (declared after the window, so destroyed before it) is still alive; the destructor would be too late.
+void MainWindow::closeEvent(QCloseEvent *event) {
+    if (board->info) {
+        board->info->writeExit(board->info->username);
+    }
+    QMainWindow::closeEvent(event);
 }
\ No newline at end of file
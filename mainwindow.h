@@ -1,25 +1,29 @@
-#ifndef MAINWINDOW_H
-#define MAINWINDOW_H
-
-#include <QMainWindow>
-
-class ChessBoard;  // Forward declare that this is a class so it can be initialized in the header file without compilation errors
-
-// Extend the QMainWindow class that we inherit from Qt
-class MainWindow : public QMainWindow {
-    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
-
-    // Pre-declare method headers to avoid compilation errors (what we do in all header files)
-    public:
-        ChessBoard* board = nullptr;  // Declare the reference to the board in public so it can be accessed anywhere in the program
-
-        MainWindow(QWidget *parent = nullptr);  // Initialize main window
-        void moveEvent(QMoveEvent *event);  // When the window is moved, we need to send a signal so our dialog can followParent
-        ~MainWindow();  // On destruction, check if the user is in the middle of a game so we can mark their file before volatile information (color, opponent elo) is deleted
-
-    // Signals connect to slot actions; the signal is triggered, and the slot acts
-    signals:
-        void geometryChanged();
-};
-
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+
+class ChessBoard;  // Forward declare that this is a class so it can be initialized in the header file without compilation errors
+class MoveListModel;
+
+// Extend the QMainWindow class that we inherit from Qt
+class MainWindow : public QMainWindow {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
+
+    // Pre-declare method headers to avoid compilation errors (what we do in all header files)
+    public:
+        ChessBoard* board = nullptr;  // Declare the reference to the board in public so it can be accessed anywhere in the program
+        MoveListModel* moveList = nullptr;  // Moves of the current game in SAN, shown in the panel to the right of the board
+
+        MainWindow(QWidget *parent = nullptr);  // Initialize main window
+        void moveEvent(QMoveEvent *event);  // When the window is moved, we need to send a signal so our dialog can followParent
+
+    protected:
+        void closeEvent(QCloseEvent *event) override;  // On close, check if the user is in the middle of a game so we can mark their file before volatile information (color, opponent elo) is deleted
+
+    // Signals connect to slot actions; the signal is triggered, and the slot acts
+    signals:
+        void geometryChanged();
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "movelistmodel.h"
+
+MoveListModel::MoveListModel(QObject *parent)
+    : QAbstractListModel(parent) {}
+
+int MoveListModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) { return 0; }  // Flat list
+    return rowsFor(plies.size());
+}
+
+QVariant MoveListModel::data(const QModelIndex &index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= rowCount()) { return QVariant(); }
+
+    const int number = firstMove + index.row();
+    const int white = 2 * index.row() - offset;  // -1 in a row that black opened
+    if (white < 0) { return QString("%1... %2").arg(number).arg(plies.at(0)); }
+
+    QString text = QString("%1. %2").arg(number).arg(plies.at(white));
+    if (white + 1 < plies.size()) { text += "  " + plies.at(white + 1); }
+
+    return text;
+}
+
+void MoveListModel::appendMove(const QString &san) {
+    // White's move (or a first move by black) opens a new row, black's completes the last one
+    const int row = rowCount();
+    if (rowsFor(plies.size() + 1) > row) {
+        beginInsertRows(QModelIndex(), row, row);
+        plies.append(san);
+        endInsertRows();
+    }
+    else {
+        plies.append(san);
+        const QModelIndex last = index(rowCount() - 1);
+        emit dataChanged(last, last, {Qt::DisplayRole});
+    }
+}
+
+void MoveListModel::removeLastMove() {
+    if (plies.isEmpty()) { return; }
+
+    if (rowsFor(plies.size() - 1) < rowCount()) {
+        const int row = rowCount() - 1;
+        beginRemoveRows(QModelIndex(), row, row);
+        plies.removeLast();
+        endRemoveRows();
+    }
+    else {
+        plies.removeLast();
+        const QModelIndex last = index(rowCount() - 1);
+        emit dataChanged(last, last, {Qt::DisplayRole});
+    }
+}
+
+void MoveListModel::clear(bool blackFirst, int moveNumber) {
+    beginResetModel();
+    plies.clear();
+    offset = blackFirst ? 1 : 0;
+    firstMove = moveNumber;
+    endResetModel();
+}
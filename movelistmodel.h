@@ -0,0 +1,33 @@
+#ifndef MOVELISTMODEL_H
+#define MOVELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+
+// Game history in SAN, one row per full move (eg: "12. Nf3  Nc6"; "1... e5" when the game starts with black to move). Moves are
+// appended and removed one ply at a time, so a long game never re-derives its earlier moves, and the view (a QListView with uniform
+// item sizes) only asks for the rows on screen.
+class MoveListModel : public QAbstractListModel {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation); creates a moc_ file
+
+    public:
+        MoveListModel(QObject *parent = nullptr);
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Connected to GameController in MainWindow
+    public slots:
+        void appendMove(const QString &san);  // One ply, already in SAN
+        void removeLastMove();  // Review stepping back
+        void clear(bool blackFirst = false, int moveNumber = 1);  // New game or review, from its start position
+
+    private:
+        QStringList plies;
+        int offset = 0;  // 1 if black moved first, so the first row holds black's move alone
+        int firstMove = 1;  // Move number of the first row
+
+        int rowsFor(int plyCount) const { return plyCount == 0 ? 0 : (plyCount + offset + 1) / 2; }
+};
+
+#endif
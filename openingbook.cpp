@@ -0,0 +1,93 @@
+#include "openingbook.h"
+#include <QtEndian>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QPair>
+#include <cmath>
+
+// Entry layout, all big endian: key (8 bytes), move (2), weight (2), learn (4)
+static const int ENTRY_SIZE = 16;
+
+OpeningBook::OpeningBook(const QString &filePath) {
+    if (filePath.isEmpty()) { return; }
+
+    file.setFileName(filePath);
+    if (!file.exists()) { return; }  // Playing without a book is normal
+    if (!file.open(QIODevice::ReadOnly) || file.size() < ENTRY_SIZE || file.size() % ENTRY_SIZE != 0) {
+        qWarning("Opening book is missing or not a Polyglot file; playing without it");
+        return;
+    }
+
+    entries = file.map(0, file.size());
+    if (!entries) {
+        qWarning("Failed to map opening book; playing without it");
+        file.close();
+        return;
+    }
+    count = file.size() / ENTRY_SIZE;
+}
+
+OpeningBook::~OpeningBook() {
+    if (entries) { file.unmap(const_cast<uchar*>(entries)); }
+}
+
+chess::Move OpeningBook::probe(const chess::Board &board, const chess::Movelist &legalMoves, int elo) const {
+    if (!entries) { return chess::Move::NO_MOVE; }
+
+    const quint64 key = board.hash();
+
+    // Gather the legal book moves for this position; the entries for one key are contiguous
+    QVector<QPair<chess::Move, double>> candidates;
+    double total = 0;
+    const double sharpness = 1.0 + qMax(0, elo - 800) / 800.0;  // 1 at 800 Elo, 4 at 3200
+    for (qint64 i = lowerBound(key); i < count; ++i) {
+        const uchar *entry = entries + i * ENTRY_SIZE;
+        if (qFromBigEndian<quint64>(entry) != key) { break; }
+
+        const quint16 weight = qFromBigEndian<quint16>(entry + 10);
+        const chess::Move move = toMove(qFromBigEndian<quint16>(entry + 8), legalMoves);
+        if (weight == 0 || move == chess::Move::NO_MOVE) { continue; }
+
+        const double w = std::pow(double(weight), sharpness);
+        candidates.append(qMakePair(move, w));
+        total += w;
+    }
+    if (candidates.isEmpty()) { return chess::Move::NO_MOVE; }
+
+    // Roulette wheel over the weights
+    double pick = QRandomGenerator::global()->generateDouble() * total;
+    for (const auto &candidate : candidates) {
+        pick -= candidate.second;
+        if (pick < 0) { return candidate.first; }
+    }
+    return candidates.last().first;
+}
+
+qint64 OpeningBook::lowerBound(quint64 key) const {
+    qint64 low = 0, high = count;
+    while (low < high) {
+        const qint64 mid = low + (high - low) / 2;
+        if (qFromBigEndian<quint64>(entries + mid * ENTRY_SIZE) < key) { low = mid + 1; }
+        else { high = mid; }
+    }
+    return low;
+}
+
+chess::Move OpeningBook::toMove(quint16 bookMove, const chess::Movelist &legalMoves) {
+    // Polyglot move: to square in bits 0-5, from square in bits 6-11 (a1 = 0), promotion in bits 12-14 (1 = knight .. 4 = queen).
+    // Castling is written king takes own rook, the same way chess.hpp encodes it, so every book move maps onto a legal move directly.
+    const int to = bookMove & 0x3F;
+    const int from = (bookMove >> 6) & 0x3F;
+    const int promotion = (bookMove >> 12) & 0x7;
+
+    for (const chess::Move &move : legalMoves) {
+        if (move.from().index() != from || move.to().index() != to) { continue; }
+
+        const bool isPromotion = move.typeOf() == chess::Move::PROMOTION;
+        if (isPromotion != (promotion != 0)) { continue; }
+        if (isPromotion && int(move.promotionType()) != promotion) { continue; }  // PieceType KNIGHT..QUEEN are 1..4 as well
+
+        return move;
+    }
+    return chess::Move::NO_MOVE;
+}
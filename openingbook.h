@@ -0,0 +1,31 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <QFile>
+#include <QString>
+#include "chess.hpp"
+
+// Reads a Polyglot (.bin) opening book so the computer can answer known openings without asking stockfish.
+// The file is memory mapped and searched in place; chess::Board::hash() already uses the Polyglot keys.
+class OpeningBook {
+    public:
+        explicit OpeningBook(const QString &filePath);  // A missing or malformed file leaves the book closed
+        ~OpeningBook();
+
+        bool isOpen() const { return entries != nullptr; }
+        qint64 size() const { return count; }
+
+        // A book move for the position picked at random by weight, or Move::NO_MOVE when out of book.
+        // Low Elo samples the weights as they are (varied play); higher Elo sharpens them towards the main line.
+        chess::Move probe(const chess::Board &board, const chess::Movelist &legalMoves, int elo) const;
+
+    private:
+        QFile file;
+        const uchar *entries = nullptr;  // Mapped view of the file, 16 bytes per entry sorted by key
+        qint64 count = 0;
+
+        qint64 lowerBound(quint64 key) const;  // First entry whose key is not less than key
+        static chess::Move toMove(quint16 bookMove, const chess::Movelist &legalMoves);  // NO_MOVE if it is not legal here
+};
+
+#endif
@@ -1,158 +1,366 @@
-#pragma once
-#include <QObject>
-#include <QProcess>
-#include <QString>
-#include <QDateTime>
-#include <QThread>
-
-class StockfishEngine : public QObject {
-    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation)
-    public:
-        // By setting the mainwindow as the parent, it will shut it down when it it closed
-        explicit StockfishEngine(QObject* parent=nullptr) : QObject(parent) {}
-
-        bool start(const QString& enginePath) {
-            stop();  // Shut down any previous actions
-
-            // Make a QProcess and have it run the stockfish executable
-            proc_ = new QProcess(this);
-            proc_->setProgram(enginePath);
-
-            proc_->setProcessChannelMode(QProcess::MergedChannels);
-
-            // Launch; if it takes more than four seconds, fold
-            proc_->start();
-            if (!proc_->waitForStarted(4000)) { return false; }
-
-            // Switch the engine to uci and give it four seconds to confirm
-            if (!send("uci") || !waitFor("uciok", 4000)) { return false; }
-
-            // Send basic options to save CPU power
-            send("setoption name Threads value 1");
-            send("setoption name Hash value 256");
-            send("setoption name Ponder value false");
-            send("setoption name MultiPV value 1");
-            send("setoption name Contempt value 0"); 
-            send("setoption name Move Overhead value 0");
-            send("setoption name Skill Level value 20");
-
-            // Send the okay and wait for a response
-            return isReady(3000);
-        }
-
-        void stop() {
-            if (!proc_) { return; }  // Nothing to stop, just return
-
-            // Quit and wait for the signal to be recieved
-            send("quit");
-            proc_->waitForFinished(200);
-
-            // Mark for deletion and clear process + buffer
-            proc_->deleteLater();
-            proc_ = nullptr;
-            buf_.clear();
-
-            // Next time we start it will be a fresh game
-            freshGame_ = true;
-        }
-
-        bool setElo(int elo) {
-            if (elo < 800) elo = 800;
-            if (elo > 3200) elo = 3200;
-
-            // Limit strength to requested Elo
-            const bool ok =
-                send("setoption name UCI_LimitStrength value true")       &&
-                send(QString("setoption name UCI_Elo value %1").arg(elo)) &&
-                isReady(2000);
-
-            // If properly executed, return true
-            return ok;
-        }
-
-        QString bestMove(const QString& fen, int movetimeMs = 1000) {
-            if (freshGame_) {
-                // Send ucinewgame to stockfish so it can clear transposition table
-                if (!send("ucinewgame") || !isReady(2000)) { return {}; }
-
-                // Flip
-                freshGame_ = false;
-            }
-            buf_.clear();
-
-            // Sends the fen position and the movetime to stockfish
-            if (!send(QString("position fen %1").arg(fen))) { return {}; }
-            if (!send(QString("go movetime %1").arg(movetimeMs))) { return {}; }
-
-            // Returns the best move
-            return waitBestMove(movetimeMs + 5000);
-        }
-
-        // Call this when you start a brand new game (no arg changes elsewhere).
-        void markNewGame() { 
-            freshGame_ = true; 
-        }
-
-    private:
-        // Declare class variables
-        QProcess* proc_ = nullptr;
-        QString buf_;
-        bool freshGame_ = true;
-
-        // Time helper
-        static qint64 nowMs() { return QDateTime::currentMSecsSinceEpoch(); }
-
-        bool send(const QString& s) {
-            if (!proc_) { return false; }
-            // Write a newline (uci requires utf8)
-            const QByteArray b = (s + "\n").toUtf8();
-            if (proc_->write(b) == -1) { return false; }
-
-            // Waits one second to be accepted
-            return proc_->waitForBytesWritten(1000);
-        }
-
-        bool isReady(int timeoutMs) {
-            if (!send("isready")) { return false; }
-
-            return waitFor("readyok", timeoutMs);
-        }
-
-        bool waitFor(const QString& token, int timeoutMs) {
-            const qint64 end = nowMs() + timeoutMs;  // Calculate endtime
-            while (nowMs() < end) {
-                if (!proc_->waitForReadyRead(50)) { continue; }  // Wait for new data
-                buf_ += QString::fromUtf8(proc_->readAll());  // Append new data to the buffer
-
-                int nl;
-                while ((nl = buf_.indexOf('\n')) != -1) {  // Read line by line
-                    const QString line = buf_.left(nl).trimmed();
-
-                    buf_.remove(0, nl + 1);  // Remove each line
-                    if (line == token) { return true; }  // If it is token, success
-                }
-            }
-
-            return false;
-        }
-
-        QString waitBestMove(int timeoutMs) {
-            const qint64 end = nowMs() + timeoutMs;  // Calculate endtime
-            while (nowMs() < end) {
-                if (!proc_->waitForReadyRead(50)) { continue; }  // Wait for new data
-                buf_ += QString::fromUtf8(proc_->readAll());  // Append new data to the buffer
-
-                int nl;
-                while ((nl = buf_.indexOf('\n')) != -1) {  // Read line by line
-                    const QString line = buf_.left(nl).trimmed();
-
-                    buf_.remove(0, nl + 1);  // Remove each line
-                    if (line.startsWith("bestmove ")) {
-                        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-                        return (parts.size() >= 2) ? parts[1] : QString{};  // Return the move in uci
-                    }
-                }
-            }
-            return {};
-        }
+#pragma once
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QThread>
+#include "ucireader.h"
+#include "engineprofile.h"
+
+// How long one search may take: a fixed movetime, or both clocks so stockfish's own time manager decides
+struct SearchLimits {
+    int movetimeMs = 0;  // Non-zero means think exactly this long and ignore the clocks
+    qint64 wtimeMs = 0;
+    qint64 btimeMs = 0;
+    int wincMs = 0;
+    int bincMs = 0;
+
+    static SearchLimits movetime(int ms) {
+        SearchLimits limits;
+        limits.movetimeMs = ms;
+        return limits;
+    }
+
+    static SearchLimits clocks(qint64 wtime, qint64 btime, int winc, int binc) {
+        SearchLimits limits;
+        limits.wtimeMs = wtime;
+        limits.btimeMs = btime;
+        limits.wincMs = winc;
+        limits.bincMs = binc;
+        return limits;
+    }
+
+    // Arguments for the go command (eg: "wtime 300000 btime 295000 winc 3000 binc 3000")
+    QString goArgs() const {
+        if (movetimeMs > 0) { return QString("movetime %1").arg(movetimeMs); }
+
+        return QString("wtime %1 btime %2 winc %3 binc %4").arg(wtimeMs).arg(btimeMs).arg(wincMs).arg(bincMs);
+    }
+};
+
+class StockfishEngine : public QObject {
+    Q_OBJECT  // Declare the class as a Qt meta-object, meaning it can be manipulated at runtime (after compilation)
+    public:
+        // By setting the mainwindow as the parent, it will shut it down when it it closed
+        explicit StockfishEngine(QObject* parent=nullptr) : QObject(parent) {}
+
+        bool start(const QString& enginePath, const EngineProfile& profile = EngineProfile::play()) {
+            stop();  // Shut down any previous actions
+            enginePath_ = enginePath;  // Remembered for restart()
+
+            // Make a QProcess and have it run the stockfish executable
+            proc_ = new QProcess(this);
+            proc_->setProgram(enginePath);
+
+            proc_->setProcessChannelMode(QProcess::MergedChannels);
+
+            // Every line the engine prints goes through onReadyRead, including the handshake replies waited on below
+            connect(proc_, &QProcess::readyRead, this, &StockfishEngine::onReadyRead);
+            // Any exit we did not ask for through stop() is a crash
+            connect(proc_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &StockfishEngine::onFinished);
+
+            // Launch; if it takes more than four seconds, fold
+            proc_->start();
+            if (!proc_->waitForStarted(4000)) { return false; }
+
+            // Switch the engine to uci and give it four seconds to confirm
+            uciOk_ = false;
+            if (!send("uci") || !waitUntil([this] { return uciOk_; }, 4000)) { return false; }
+
+            // Threads, hash and the other options come from the profile; applyProfile waits for the okay
+            return applyProfile(profile, true);
+        }
+
+        // Switch to another resource profile (eg: a play engine leased for analysis); a no-op if it is already applied
+        bool applyProfile(const EngineProfile& profile, bool force = false) {
+            if (!force && profile == profile_) { return true; }
+            profile_ = profile;
+
+            for (const QString& cmd : profile.setoptionCommands()) {
+                if (!send(cmd)) { return false; }
+            }
+
+            // Resizing the hash can take a moment; wait for the okay before searching
+            return isReady(10000);
+        }
+
+        const EngineProfile& profile() const {
+            return profile_;
+        }
+
+        void stop() {
+            if (!proc_) { return; }  // Nothing to stop, just return
+
+            // Quit and wait for the signal to be recieved (disconnect first, this exit is not a crash)
+            disconnect(proc_, nullptr, this, nullptr);
+            send("quit");
+            proc_->waitForFinished(200);
+
+            // Mark for deletion and clear process + buffer
+            proc_->deleteLater();
+            proc_ = nullptr;
+            reader_.clear();
+            outstanding_ = 0;
+            discard_ = false;
+            pondering_ = false;
+
+            // Next time we start it will be a fresh game
+            freshGame_ = true;
+        }
+
+        bool setElo(int elo) {
+            if (elo < 800) elo = 800;
+            if (elo > 3200) elo = 3200;
+            elo_ = elo;  // Reapplied by restart()
+
+            // Limit strength to requested Elo
+            const bool ok =
+                send("setoption name UCI_LimitStrength value true")       &&
+                send(QString("setoption name UCI_Elo value %1").arg(elo)) &&
+                isReady(2000);
+
+            // If properly executed, return true
+            return ok;
+        }
+
+        // Search the game built up with pushMove and return immediately; the result is delivered through bestMoveReady
+        bool searchBestMove(const SearchLimits& limits) {
+            if (pondering_) {
+                pondering_ = false;
+
+                // The user played the predicted move: the ponder search simply becomes the real one
+                if (moves_.size() == ponderPly_ && moves_.last() == ponderMove_) { return send("ponderhit"); }
+
+                stopSearch();  // Wrong guess, throw the ponder search away
+            }
+            if (isSearching()) { return false; }  // One search at a time
+
+            if (freshGame_) {
+                // Send ucinewgame to stockfish so it can clear transposition table
+                if (!send("ucinewgame") || !isReady(2000)) { return false; }
+
+                // Flip
+                freshGame_ = false;
+            }
+
+            // Sends the whole game (so stockfish sees repetitions) and the time limits to stockfish
+            if (!send(positionCmd_)) { return false; }
+            searchWhite_ = whiteToMove(moves_.size());  // Side to move, so info scores can be turned to white's view
+
+            // Count the search before sending go, so a fast bestmove is not missed by onReadyRead
+            outstanding_++;
+            if (!send("go " + limits.goArgs())) {
+                outstanding_--;
+                return false;
+            }
+            return true;
+        }
+
+        // Think on the user's time: search the game plus the reply stockfish expects (the ponder move of its last bestmove).
+        // Call after the computer's move has been pushed; the next searchBestMove turns this into a ponderhit if the guess was right.
+        bool ponder(const SearchLimits& limits) {
+            if (!profile_.ponder || lastPonder_.isEmpty() || outstanding_ > 0) { return false; }
+
+            ponderMove_ = lastPonder_;
+            ponderPly_ = moves_.size() + 1;
+            if (!send(positionCmd_ + (moves_.isEmpty() ? " moves " : " ") + ponderMove_)) { return false; }
+            searchWhite_ = whiteToMove(ponderPly_);
+
+            // Same limits as a normal search; after a ponderhit stockfish counts the time already spent pondering,
+            // so it usually answers at once
+            outstanding_++;
+            pondering_ = true;
+            if (!send("go ponder " + limits.goArgs())) {
+                outstanding_--;
+                pondering_ = false;
+                return false;
+            }
+            return true;
+        }
+
+        // Abandon the current search (or ponder); stockfish answers stop immediately, so wait for (and swallow) its bestmove
+        void stopSearch() {
+            pondering_ = false;
+            if (outstanding_ == 0) { return; }
+
+            discard_ = true;
+            send("stop");
+
+            waitUntil([this] { return outstanding_ == 0; }, 1000);
+
+            outstanding_ = 0;
+            discard_ = false;
+        }
+
+        // Pondering does not count: a ponder search is there to be taken over by the next searchBestMove
+        bool isSearching() const { 
+            return outstanding_ > 0 && !pondering_; 
+        }
+
+        // Play at full strength again (eg: an engine recycled from a game for analysis)
+        bool clearElo() {
+            elo_ = 0;
+            return send("setoption name UCI_LimitStrength value false") && isReady(2000);
+        }
+
+        // Bring the engine back with the same executable and strength, eg: after a crash
+        bool restart() {
+            if (enginePath_.isEmpty()) { return false; }
+            if (!start(enginePath_, profile_)) { return false; }
+
+            return (elo_ == 0) || setElo(elo_);
+        }
+
+        bool isRunning() const {
+            return proc_ && proc_->state() == QProcess::Running;
+        }
+
+        // Call this when you start a brand new game; startFen is only needed when the game does not begin from the start position
+        void markNewGame(const QString& startFen = QString()) { 
+            stopSearch();  // A search of the old game is of no use any more
+            freshGame_ = true; 
+
+            moves_.clear();
+            lastPonder_.clear();
+            startWhite_ = (startFen.section(' ', 1, 1) != "b");
+            positionCmd_ = startFen.isEmpty() ? QString("position startpos") : QString("position fen %1").arg(startFen);
+        }
+
+        // Record a move played in the game (either side, in uci, eg: "e1g1"); only the new move is appended to the position command
+        void pushMove(const QString& uci) {
+            // A move that did not come from our last bestmove (user move, cached answer) makes the ponder guess meaningless
+            if (uci != lastBest_) { lastPonder_.clear(); }
+            lastBest_.clear();
+
+            positionCmd_ += (moves_.isEmpty() ? " moves " : " ") + uci;
+            moves_ << uci;
+        }
+
+        // Take back the last pushMove (eg: stepping back through a reviewed game); the hash stays, unlike markNewGame
+        void popMove() {
+            if (moves_.isEmpty()) { return; }
+            stopSearch();
+            lastPonder_.clear();
+            lastBest_.clear();
+
+            positionCmd_.chop(moves_.takeLast().size() + 1);  // The move and the space before it
+            if (moves_.isEmpty()) { positionCmd_.chop(QString(" moves").size()); }
+        }
+
+    signals:
+        void bestMoveReady(const QString& move);  // Emitted when a search started by searchBestMove finishes (empty on failure)
+        void infoReady(const EngineInfo& info);  // Emitted for every scored info line of the running search
+        void crashed();  // The process exited without stop() being called
+
+    private:
+        // Declare class variables
+        QProcess* proc_ = nullptr;
+        UciReader reader_;
+        QString enginePath_;
+        EngineProfile profile_;
+        int elo_ = 0;  // 0 means full strength
+        bool freshGame_ = true;
+        bool uciOk_ = false;  // Set by onReadyRead when the matching reply arrives
+        bool readyOk_ = false;
+        int outstanding_ = 0;  // go commands still waiting for their bestmove
+        bool discard_ = false;  // Set while a stopped search drains, so its bestmove is not reported
+        bool searchWhite_ = true;  // White to move in the position being searched
+        QString lastBest_;  // Move of the last bestmove, until it is pushed
+        QString lastPonder_;  // Reply predicted by the last bestmove, empty if none was given
+        QString ponderMove_;  // Reply the running ponder search is betting on
+        int ponderPly_ = 0;  // Length of the move list once that reply is played
+        bool pondering_ = false;
+
+        // The game so far; positionCmd_ is "position startpos moves ..." kept in step with moves_
+        QStringList moves_;
+        QString positionCmd_ = "position startpos";
+        bool startWhite_ = true;  // Side to move in the start position
+
+        bool whiteToMove(int ply) const {
+            return (ply % 2 == 0) == startWhite_;
+        }
+
+        // Time helper
+        static qint64 nowMs() { return QDateTime::currentMSecsSinceEpoch(); }
+
+        bool send(const QString& s) {
+            if (!proc_) { return false; }
+            // Write a newline (uci requires utf8)
+            const QByteArray b = (s + "\n").toUtf8();
+            if (proc_->write(b) == -1) { return false; }
+
+            // Waits one second to be accepted
+            return proc_->waitForBytesWritten(1000);
+        }
+
+        bool isReady(int timeoutMs) {
+            readyOk_ = false;
+            if (!send("isready")) { return false; }
+
+            return waitUntil([this] { return readyOk_; }, timeoutMs);
+        }
+
+        // Block until done() holds; waitForReadyRead returns as soon as bytes arrive, so this costs engine time, not polling time
+        template <typename Done>
+        bool waitUntil(Done done, int timeoutMs) {
+            const qint64 end = nowMs() + timeoutMs;  // Calculate endtime
+            while (!done()) {
+                const qint64 left = end - nowMs();
+                if (!proc_ || left <= 0 || !proc_->waitForReadyRead(int(left))) { return done(); }
+
+                // QProcess does not re-emit readyRead while we are already inside onReadyRead, so drain it ourselves
+                if (proc_->bytesAvailable() > 0) { onReadyRead(); }
+            }
+            return true;
+        }
+
+        void onFinished(int, QProcess::ExitStatus) {
+            const bool wasSearching = isSearching();
+
+            reader_.clear();
+            outstanding_ = 0;
+            discard_ = false;
+            pondering_ = false;
+            freshGame_ = true;
+
+            // Nobody should sit waiting for a bestmove that is never coming
+            if (wasSearching) { emit bestMoveReady(QString()); }
+            emit crashed();
+        }
+
+        // Driven by QProcess::readyRead; dispatches each complete line the engine has printed
+        void onReadyRead() {
+            reader_.feed(proc_->readAll());
+
+            UciRecord rec;
+            while (reader_.next(rec)) {
+                switch (rec.type) {
+                    case UciRecord::UciOk:   uciOk_ = true; break;
+                    case UciRecord::ReadyOk: readyOk_ = true; break;
+                    case UciRecord::Info: {
+                        if (outstanding_ == 0 || discard_) { break; }  // Left over from a finished or stopped search
+
+                        EngineInfo info;
+                        if (UciReader::parseInfo(rec.line, info)) {
+                            info.whiteToMove = searchWhite_;
+                            emit infoReady(info);
+                        }
+                        break;
+                    }
+                    case UciRecord::BestMove: {
+                        if (outstanding_ == 0) { break; }  // Not ours (eg: a stop sent with nothing running)
+                        outstanding_--;
+                        if (discard_) { break; }  // Answer to a stopped search, nobody is waiting on it
+
+                        lastBest_ = QString::fromLatin1(rec.move);
+                        lastPonder_ = QString::fromLatin1(rec.ponder);
+
+                        emit bestMoveReady(QString::fromLatin1(rec.move));  // Deliver the move in uci
+                        break;
+                    }
+                    default: break;
+                }
+            }
+        }
 };
\ No newline at end of file
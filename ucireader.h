@@ -0,0 +1,150 @@
+#pragma once
+#include <QByteArray>
+#include <QStringList>
+#include <QMetaType>
+#include <cstring>
+
+// One line of engine output, classified by its leading keyword
+struct UciRecord {
+    enum Type { Other, UciOk, ReadyOk, BestMove, Info };
+
+    Type type = Other;
+    QByteArray line;  // The whole line without its newline
+    QByteArray move;  // bestmove only: the move in uci (eg: "e2e4")
+    QByteArray ponder;  // bestmove only: the reply the engine expects, empty if it gave none
+};
+
+// Search progress from one "info depth ... score ... nodes ... nps ... pv ..." line
+struct EngineInfo {
+    int depth = 0;
+    int seldepth = 0;
+    int multipv = 1;
+    bool mate = false;  // score counts moves to mate (negative: being mated) instead of centipawns
+    int score = 0;  // From the side to move's point of view, as stockfish reports it
+    bool lowerbound = false;
+    bool upperbound = false;
+    qint64 nodes = 0;
+    qint64 nps = 0;
+    int timeMs = 0;
+    int hashfull = 0;  // Per mille of the hash table in use
+    QStringList pv;  // Principal variation in uci
+    bool whiteToMove = true;  // Filled in by StockfishEngine from the position it is searching
+
+    // Score from white's point of view in centipawns; mates are pinned to +-10000 so they sort above any evaluation
+    int whiteCp() const {
+        const int cp = mate ? (score > 0 ? 10000 : -10000) : score;
+        return whiteToMove ? cp : -cp;
+    }
+};
+Q_DECLARE_METATYPE(EngineInfo)
+
+// Incremental reader for the engine's stdout. Bytes are appended with feed() and complete lines are pulled out with next().
+// A cursor walks the buffer instead of removing each line from the front, so splitting is linear in the bytes received.
+// The QByteArrays handed out by next() point straight into the buffer (no copy); they are only valid until the next feed().
+class UciReader {
+    public:
+        void feed(const QByteArray& data) {
+            // Drop the lines already handed out once per feed, not once per line
+            if (pos_ > 0) {
+                buf_.remove(0, pos_);
+                pos_ = 0;
+            }
+            buf_.append(data);
+        }
+
+        // Fill rec with the next complete line; false once only a partial line (or nothing) is left
+        bool next(UciRecord& rec) {
+            while (pos_ < buf_.size()) {
+                const char* begin = buf_.constData() + pos_;
+                const char* nl = static_cast<const char*>(std::memchr(begin, '\n', buf_.size() - pos_));
+                if (!nl) { return false; }  // Wait for the rest of the line
+
+                pos_ += int(nl - begin) + 1;
+
+                // Trim the trailing "\r" (Windows builds) and whitespace, skip blank lines
+                const char* end = nl;
+                while (end > begin && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) { --end; }
+                while (begin < end && (*begin == ' ' || *begin == '\t')) { ++begin; }
+                if (begin == end) { continue; }
+
+                parse(QByteArray::fromRawData(begin, int(end - begin)), rec);
+                return true;
+            }
+            return false;
+        }
+
+        void clear() {
+            buf_.clear();
+            pos_ = 0;
+        }
+
+        // Return the space separated token starting at or after from, and move from past it
+        static QByteArray token(const QByteArray& line, int& from) {
+            const int n = line.size();
+            while (from < n && line.at(from) == ' ') { ++from; }
+
+            const int start = from;
+            while (from < n && line.at(from) != ' ') { ++from; }
+
+            return QByteArray::fromRawData(line.constData() + start, from - start);
+        }
+
+        // Fill info from an "info" line; false for lines that carry no evaluation (info string, currmove updates)
+        static bool parseInfo(const QByteArray& line, EngineInfo& info) {
+            info = EngineInfo();
+            bool hasScore = false;
+
+            int at = 0;
+            token(line, at);  // "info"
+            while (at < line.size()) {
+                const QByteArray key = token(line, at);
+
+                if (key == "depth")           { info.depth = token(line, at).toInt(); }
+                else if (key == "seldepth")   { info.seldepth = token(line, at).toInt(); }
+                else if (key == "multipv")    { info.multipv = token(line, at).toInt(); }
+                else if (key == "nodes")      { info.nodes = token(line, at).toLongLong(); }
+                else if (key == "nps")        { info.nps = token(line, at).toLongLong(); }
+                else if (key == "time")       { info.timeMs = token(line, at).toInt(); }
+                else if (key == "hashfull")   { info.hashfull = token(line, at).toInt(); }
+                else if (key == "lowerbound") { info.lowerbound = true; }
+                else if (key == "upperbound") { info.upperbound = true; }
+                else if (key == "score") {
+                    info.mate = (token(line, at) == "mate");  // "cp" or "mate"
+                    info.score = token(line, at).toInt();
+                    hasScore = true;
+                }
+                else if (key == "pv") {
+                    // The pv runs to the end of the line
+                    while (at < line.size()) {
+                        const QByteArray mv = token(line, at);
+                        if (!mv.isEmpty()) { info.pv << QString::fromLatin1(mv); }
+                    }
+                }
+                else if (key == "string") { return false; }  // Free text, nothing to parse
+            }
+
+            return hasScore && info.depth > 0;
+        }
+
+    private:
+        QByteArray buf_;
+        int pos_ = 0;  // Start of the first line not yet handed out
+
+        static void parse(const QByteArray& line, UciRecord& rec) {
+            rec = UciRecord();
+            rec.line = line;
+
+            int at = 0;
+            const QByteArray first = token(line, at);
+
+            if (first == "info")          { rec.type = UciRecord::Info; }
+            else if (first == "readyok")  { rec.type = UciRecord::ReadyOk; }
+            else if (first == "uciok")    { rec.type = UciRecord::UciOk; }
+            else if (first == "bestmove") {
+                // "bestmove e2e4 ponder e7e5"; the ponder part is optional
+                rec.type = UciRecord::BestMove;
+                rec.move = token(line, at);
+                if (token(line, at) == "ponder") { rec.ponder = token(line, at); }
+            }
+        }
+};
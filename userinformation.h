@@ -1,72 +1,103 @@
-#ifndef USERINFORMATION_H
-#define USERINFORMATION_H
-
-#include <iostream>  // Input and output; cin, cout, endl
-#include <fstream>  // Enables file input and output; ifstream, ofstream
-#include <sstream>  // Used for formatting strings like streams
-#include <string>
-#include <map>  // Gives us a sorted container which is implemented as a binary tree
-#include <iomanip>
-#include <openssl/sha.h>  // Uses lssl and lcrypto; if we dont compile the program by linking these libraries, this will throw an error
-#include <random>
-#include <cctype>  // Allows us to check character types
-#include <algorithm>
-#include <QWidget>
-#include <stack>
-#include "runstockfish.h"
-
-class UserInformation {
-    public:
-        // From the prompt in main, direct the user to either login or register
-        UserInformation(int input, QWidget *parent);
-
-        // Public fields; will be accessed form chessboard after the event loop has started
-        int elo, gameMode;  // Elo is used for opponent strength; gameMode is used to indictate if the user is playing or reviewing
-        bool isWhite, running, computerTurn;  // User piece color, engine setElo bool, computerTurn bool
-        std::string username;  // Username is needed to write to the individual file
-
-        void promptGameMode(QWidget *parentWidget);  // Prompt the user to play or review
-
-        // Used for review mode
-        std::stack<std::string> forwardMoves;
-        std::stack<std::string> backwardMoves;
-        QString sReviewInfo;
-
-        // Writing each move and outcome to the individuals file
-        void writeMove(const std::string& username, const std::string& move);  // Move
-        void writeQuit(const std::string& username);  // User exits window unnaturally
-        void writeExit(const std::string& username);  // User exits window naturally
-        void writeCM(const std::string& username, const std::string& loser);  // Checkmate
-        void writeStale(const std::string& username);  // Stalemate
-        void writeIN(const std::string& username);  // Insufficient material
-        void writeThree(const std::string& username);  // Threefold repitition
-        void writeFifty(const std::string& username);  // Fifty move rule
-
-        StockfishEngine* engine = nullptr;
-        const QString enginePath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/extern/stockfish/stockfish.exe";
-
-        bool castleWK, castleBK, castleBQ, castleWQ;  // Alter file output on castle moves
-        
-    private:
-        const std::string USER_FILE_ROOT = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/userrecords/";  // Store individual file in user records folder
-        const std::string USERBASE_FILE = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/userbase.txt";  // Add user information to the user base
-        const std::string PEPPER = "asdjkgb1458u79sdgkuh";
-
-        void registerUser(QWidget *parentWidget);  // Register a new user
-        void loginUser(QWidget *parentWidget);  // Login an existing user
-
-        std::string generateSalt(int length = 12);
-        std::string sha256(const std::string& input);  // Imported hash function; makes the password into an irreveversible hash for safe storage
-        std::map<std::string, std::pair<std::string, std::string>> loadUsers();  // Loads from the userbase to check if the username is stored
-        void saveUser(const std::string& username, const std::string& salt, const std::string& hash);  // Saves a new registered user to the userbase
-
-        void promptForElo(QWidget *parentWidget);  // Prompt the user to play a friend (elo == 1) or to select opponent elo
-        void promptForReview(QWidget* parentWidget);  // Review a game
-
-        std::string trim(const std::string& str);  // Trim leading and trailing whitespace from input
-};
-
-// A 'PEPPER' is an unknown string used to complicate encryption so that even if the database of hashes is breached, none of them will be able to be decoded.
-// A 'SALT' is a random string that is used to ensure that every user has a unique hash, regardless of their password (perhaps not unique).
-
+#ifndef USERINFORMATION_H
+#define USERINFORMATION_H
+
+#include <iostream>  // Input and output; cin, cout, endl
+#include <fstream>  // Enables file input and output; ifstream, ofstream
+#include <sstream>  // Used for formatting strings like streams
+#include <string>
+#include <map>  // Gives us a sorted container which is implemented as a binary tree
+#include <iomanip>
+#include <openssl/sha.h>  // Uses lssl and lcrypto; if we dont compile the program by linking these libraries, this will throw an error
+#include <random>
+#include <cctype>  // Allows us to check character types
+#include <algorithm>
+#include <QWidget>
+#include "runstockfish.h"
+#include "enginepool.h"
+#include "engineprofile.h"
+#include "enginecache.h"
+#include "openingbook.h"
+#include "gamewriter.h"
+
+class UserInformation {
+    public:
+        // From the prompt in main, direct the user to either login or register; main then calls chooseGame
+        UserInformation(int input, QWidget *parent);
+
+        // Public fields; will be accessed form chessboard after the event loop has started
+        int elo, gameMode;  // Elo is used for opponent strength; gameMode is used to indictate if the user is playing or reviewing
+        bool isWhite, computerTurn;  // User piece color, computerTurn bool
+        std::string username;  // Username is needed to write to the individual file
+
+        void chooseGame(QWidget *parentWidget);  // First game of the session; a new user goes straight to a new game unless they imported games
+        void promptGameMode(QWidget *parentWidget);  // Prompt the user to play or review
+
+        // Used for review mode
+        chess::Board reviewStart;  // Position the reviewed game started from
+        std::vector<chess::Move> reviewMoves;  // Every ply of the reviewed game, replayed on the board one click at a time
+        QString sReviewInfo;
+
+        // Writing each move and outcome to the individuals file
+        void writeMove(const std::string& username, chess::Move move);  // Move
+        void writeQuit(const std::string& username);  // User exits window unnaturally
+        void writeExit(const std::string& username);  // User exits window naturally
+        void writeCM(const std::string& username, const std::string& loser);  // Checkmate
+        void writeStale(const std::string& username);  // Stalemate
+        void writeIN(const std::string& username);  // Insufficient material
+        void writeThree(const std::string& username);  // Threefold repitition
+        void writeFifty(const std::string& username);  // Fifty move rule
+        void writeTime(const std::string& username, const std::string& loser);  // Flag fell
+
+        // Bulk PGN transfer of the user's games; both stream one game at a time and return how many games moved (-1 if path fails to open)
+        int exportPgn(const std::string& path);
+        int importPgn(const std::string& path);
+
+        // When buffered moves reach the user file; results and exits always flush. Every 10 moves unless --game-durability says otherwise.
+        void setGameDurability(GameWriter::Durability durability, int flushEvery = 10);  // flushEvery: moves per flush for EveryNMoves
+
+        EnginePool* enginePool = nullptr;  // Every Stockfish process; games and analysis each lease their own
+        StockfishEngine* engine = nullptr;  // Engine leased from the pool for the game being played; nullptr between games
+        int enginePoolSize = 2;  // Processes spawned up front ([pool] size= or --engines); play and review each keep their own
+        EngineProfile playProfile = EngineProfile::play();  // Resources for the engine the user plays against
+        EngineProfile analysisProfile = EngineProfile::analysis();  // Resources for the engine that evaluates reviewed games
+        const QString engineConfigPath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/engine.ini";  // [play] / [analysis] profile overrides
+        const QString enginePath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/extern/stockfish/stockfish.exe";
+        OpeningBook* openingBook = nullptr;  // Polyglot book asked before the engine; nullptr plays without one
+        const QString openingBookPath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/book.bin";
+        EngineCache* engineCache = nullptr;  // Answers for positions seen before; nullptr plays without one
+        const QString engineCachePath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/enginecache.bin";
+        const QString engineMetricsPath = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/enginemetrics.csv";  // Info stream log (depth, nodes, nps)
+
+        // Time control for every game (--time-control); the engine receives both clocks instead of a fixed movetime, and a fallen flag loses
+        static constexpr int defaultClockStartMs = 5 * 60 * 1000;
+        int clockStartMs = defaultClockStartMs;
+        int clockIncrementMs = 3000;
+        
+    private:
+        const std::string USER_FILE_ROOT = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/userrecords/";  // Store individual file in user records folder
+        const std::string GAMES_FILE_SUFFIX = ".games";  // Binary games file (GameRecord); the old text record is the user's name alone
+        const std::string USERBASE_FILE = "C:/Users/wscal/OneDrive/Desktop/cpp/chess/userdata/userbase.txt";  // Add user information to the user base
+        bool newUser = false;  // Registered this session
+        const std::string PEPPER = "asdjkgb1458u79sdgkuh";
+
+        void registerUser(QWidget *parentWidget);  // Register a new user
+        void loginUser(QWidget *parentWidget);  // Login an existing user
+
+        std::string generateSalt(int length = 12);
+        std::string sha256(const std::string& input);  // Imported hash function; makes the password into an irreveversible hash for safe storage
+        std::map<std::string, std::pair<std::string, std::string>> loadUsers();  // Loads from the userbase to check if the username is stored
+        void saveUser(const std::string& username, const std::string& salt, const std::string& hash);  // Saves a new registered user to the userbase
+
+        GameWriter games{GameWriter::Durability::EveryNMoves, 10};  // One handle on the user file for the session; the write* functions go through it
+        GameWriter& recordFile(const std::string& username, const std::string& action);  // Open on first use (converting an old text record); exits on failure
+
+        void promptForElo(QWidget *parentWidget);  // Prompt the user to play a friend (elo == 1) or to select opponent elo
+        void promptForReview(QWidget* parentWidget);  // Review a game
+
+        std::string trim(const std::string& str);  // Trim leading and trailing whitespace from input
+};
+
+// A 'PEPPER' is an unknown string used to complicate encryption so that even if the database of hashes is breached, none of them will be able to be decoded.
+// A 'SALT' is a random string that is used to ensure that every user has a unique hash, regardless of their password (perhaps not unique).
+
 #endif
\ No newline at end of file